@@ -0,0 +1,415 @@
+/*
+ *  File: A5Bench.cpp
+ *
+ *  Description:
+ *      Repeatable microbenchmarks for the engine's hot functions.  Every benchmark is first
+ *      calibrated to an iteration count that runs for at least the minimum run time, then
+ *      timed over several runs.  Results go to stdout as CSV, one row per benchmark:
+ *
+ *          benchmark,iterations,runs,min_ns_per_op,median_ns_per_op,status
+ *
+ *      The GL benchmarks are only built with A5_BENCH_GL, so by default A5Bench links nothing
+ *      but the core and runs on machines with no GL at all.  They need a hidden window, and
+ *      without a display they are reported with a status of "skipped" and everything else
+ *      still runs.
+ *
+ *  Usage:
+ *      A5Bench [--runs N] [--min-run-ms MS] [--filter TEXT]
+ *
+ */
+
+#include "ColliderSet.h"
+#include "GameWorld.h"
+#include "Hero.h"
+#include "LevelOfDetail.h"
+#include "MeshBuilder.h"
+#include "SpatialHash.h"
+#include "StaticBVH.h"
+
+#ifdef A5_BENCH_GL
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <CSCI441/ShaderProgram.hpp>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+/// \desc results are written here so the compiler cannot throw the benchmarked work away
+static volatile GLfloat benchSink;
+
+/// \desc reaches the private rules of a world so they can be timed on their own
+class GameWorldBench {
+public:
+    static void moveHero( GameWorld& world, GLfloat dt ) { world._moveHero(world._hero.getStep(dt)); }
+    static void moveEnemies( GameWorld& world, GLfloat dt ) { world._moveEnemies(dt); }
+    static void hoverEnemies( GameWorld& world, GLfloat dt ) {
+        world._enemies.storePreviousState();
+        world._enemies.hover(dt);
+    }
+    static void placeHero( GameWorld& world, glm::vec3 position ) { world._hero.setHeroPosition(position); }
+    static void isOnTile( GameWorld& world, glm::vec3 currPos ) { world._isOnTile(currPos); }
+    static void isWinner( GameWorld& world, GLfloat dt ) { world._isWinner(dt); }
+    static void placeEnemy( GameWorld& world, GLuint enemyIndex, glm::vec3 position ) { world._enemies.setPosition(enemyIndex, position); }
+};
+
+/// \desc settings read from the command line
+struct BenchOptions {
+    /// \desc number of timed runs per benchmark
+    GLuint numRuns;
+    /// \desc iterations are doubled until a single run takes at least this long
+    GLdouble minRunMs;
+    /// \desc only benchmarks whose name contains this are run, nullptr runs everything
+    const char* filter;
+};
+
+/// \desc runs a benchmark for the given number of iterations
+/// \returns nanoseconds spent in the timed part, setup is left out
+typedef std::function<GLdouble(GLuint)> BenchFunction;
+
+typedef std::chrono::steady_clock BenchClock;
+
+static GLdouble elapsedNs( BenchClock::time_point start ) {
+    return std::chrono::duration<GLdouble, std::nano>(BenchClock::now() - start).count();
+}
+
+/// \desc positions spread over the whole world, some inside walls and tiles and some not
+static std::vector<glm::vec3> samplePositions() {
+    std::vector<glm::vec3> positions;
+    for( GLint x = -50; x <= 50; x += 5 ) {
+        for( GLint z = -50; z <= 50; z += 5 ) {
+            positions.emplace_back((GLfloat)x, 0.0f, (GLfloat)z);
+        }
+    }
+    return positions;
+}
+
+static void printRow( const char* name, GLuint iterations, GLuint numRuns, GLdouble minNs, GLdouble medianNs, const char* status ) {
+    fprintf( stdout, "%s,%u,%u,%.3f,%.3f,%s\n", name, iterations, numRuns, minNs, medianNs, status );
+    fflush( stdout );
+}
+
+static bool isSelected( const BenchOptions& options, const char* name ) {
+    return options.filter == nullptr || strstr(name, options.filter) != nullptr;
+}
+
+/// \desc calibrates, times and reports one benchmark
+static void runBenchmark( const BenchOptions& options, const char* name, const BenchFunction& benchmark ) {
+    if( !isSelected(options, name) ) return;
+
+    // double the work until a run is long enough for the clock to be trusted
+    GLuint iterations = 1;
+    while( benchmark(iterations) < options.minRunMs * 1.0e6 && iterations < (1u << 30) ) {
+        iterations *= 2;
+    }
+
+    std::vector<GLdouble> nsPerOp;
+    for( GLuint run = 0; run < options.numRuns; run++ ) {
+        nsPerOp.push_back(benchmark(iterations) / iterations);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    printRow( name, iterations, options.numRuns, nsPerOp.front(), nsPerOp[nsPerOp.size() / 2], "ok" );
+}
+
+/// \desc the game rules, none of which need a GL context
+static void runCoreBenchmarks( const BenchOptions& options ) {
+    const std::vector<glm::vec3> positions = samplePositions();
+    const auto dt = (GLfloat)(1.0 / FixedTimestep::REFERENCE_TICK_RATE);
+    // a fixed seed keeps every run of the benchmarks on the same world
+    const GLuint SEED = 441;
+
+    runBenchmark(options, "collision.heroSweep", [&](GLuint iterations) {
+        GameWorld world(2, SEED);
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GameWorldBench::placeHero(world, positions[i % positions.size()]);
+            GameWorldBench::moveHero(world, dt);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = world.getHero().getCurrPos().x;
+        return ns;
+    });
+
+    // one iteration walks the whole horde towards the hero, sweeping each enemy against the walls
+    runBenchmark(options, "collision.enemySweep64", [&](GLuint iterations) {
+        const GLuint NUM_ENEMIES = 64;
+        GameWorld world(NUM_ENEMIES, SEED);
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            for( GLuint e = 0; e < NUM_ENEMIES; e++ ) {
+                GameWorldBench::placeEnemy(world, e, positions[(i + e) % positions.size()]);
+            }
+            GameWorldBench::moveEnemies(world, dt);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = world.getEnemies().getPosition(0).x;
+        return ns;
+    });
+
+    // the per-tick bookkeeping every live enemy goes through, streamed through the horde's arrays
+    runBenchmark(options, "horde.hover4096", [&](GLuint iterations) {
+        GameWorld world(4096, SEED);
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GameWorldBench::hoverEnemies(world, dt);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = world.getEnemies().getPosition(0).y;
+        return ns;
+    });
+
+    // a stress scene's worth of walls tested one after another, several boxes per instruction
+    runBenchmark(options, "colliders.countXZ256", [&](GLuint iterations) {
+        GameWorld::Config config;
+        config.numWalls = 256;
+        config.seed = SEED;
+        GameWorld world(config);
+        ColliderSet colliders;
+        for( const AABB& box : world.getWalls().getBoxes() ) colliders.add(box);
+        GLuint hits = 0;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            hits += colliders.countContainingXZ(positions[i % positions.size()]);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = (GLfloat)hits;
+        return ns;
+    });
+
+    // the same walls and points through the hierarchy, which only visits the nearby leaves
+    runBenchmark(options, "bvh.countXZ256", [&](GLuint iterations) {
+        GameWorld::Config config;
+        config.numWalls = 256;
+        config.seed = SEED;
+        GameWorld world(config);
+        const StaticBVH& hierarchy = world.getWalls().getHierarchy();
+        GLuint hits = 0;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GLuint count;
+            hierarchy.countContainingXZ(&positions[i % positions.size()], 1, &count);
+            hits += count;
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = (GLfloat)hits;
+        return ns;
+    });
+
+    // rays from the middle of the level out through the pillars at wall height, like a camera
+    // pulled back behind the walls
+    runBenchmark(options, "bvh.raycast256", [&](GLuint iterations) {
+        GameWorld::Config config;
+        config.numWalls = 256;
+        config.seed = SEED;
+        GameWorld world(config);
+        const StaticBVH& hierarchy = world.getWalls().getHierarchy();
+        std::vector<StaticBVH::Ray> rays;
+        for( const glm::vec3& position : positions ) {
+            if( position.x == 0.0f && position.z == 0.0f ) continue;
+            rays.push_back({glm::vec3(0.0f), glm::normalize(position), glm::length(position)});
+        }
+        GLfloat distance = 0.0f;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            StaticBVH::RayHit hit;
+            hierarchy.raycast(&rays[i % rays.size()], 1, &hit);
+            distance += hit.distance;
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = distance;
+        return ns;
+    });
+
+    // one iteration rebuilds the hash for a crowded horde and finds every candidate pair
+    runBenchmark(options, "collision.enemyPairs256", [&](GLuint iterations) {
+        const GLuint NUM_ENEMIES = 256;
+        std::vector<glm::vec3> crowd;
+        std::vector<GLuint> ids;
+        for( GLuint e = 0; e < NUM_ENEMIES; e++ ) {
+            // scattered over a 40x40 patch, dense enough that a few footprints overlap
+            crowd.emplace_back((GLfloat)((e * 37) % 40) - 20.0f, 0.0f, (GLfloat)((e * 53) % 41) - 20.0f);
+            ids.push_back(e);
+        }
+        SpatialHash hash(2.5f);
+        std::vector<SpatialHash::Pair> pairs;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            hash.build(crowd.data(), ids.data(), NUM_ENEMIES);
+            hash.findPairs(pairs);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = (GLfloat)pairs.size();
+        return ns;
+    });
+
+    runBenchmark(options, "tiles.isOnTile", [&](GLuint iterations) {
+        GameWorld world(2, SEED);
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GameWorldBench::isOnTile(world, positions[i % positions.size()]);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = (GLfloat)world.getVisitedTileCount();
+        return ns;
+    });
+
+    runBenchmark(options, "tiles.isWinner", [&](GLuint iterations) {
+        GameWorld world(2, SEED);
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GameWorldBench::isWinner(world, dt);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = world.hasWon() ? 1.0f : 0.0f;
+        return ns;
+    });
+
+    runBenchmark(options, "hero.modelMatrix", [&](GLuint iterations) {
+        Hero hero;
+        GLfloat total = 0.0f;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            GLfloat alpha = (GLfloat)(i & 0xFF) / 256.0f;
+            total += hero.getRenderModelMatrix(glm::mat4(1.0f), alpha)[3].x;
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = total;
+        return ns;
+    });
+
+    runBenchmark(options, "hero.bakeMeshFinest", [&](GLuint iterations) {
+        Hero hero;
+        GLfloat total = 0.0f;
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            MeshBuilder mesh;
+            hero.addPartsToMesh(mesh, LevelOfDetail::getLevel(0));
+            total += mesh.computeBounds().maxCorner.x;
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = total;
+        return ns;
+    });
+
+    runBenchmark(options, "world.step", [&](GLuint iterations) {
+        GameWorld world(2, SEED);
+        const GameWorld::Input input = {true, false, true, false};
+        auto start = BenchClock::now();
+        for( GLuint i = 0; i < iterations; i++ ) {
+            world.step(input, dt);
+        }
+        GLdouble ns = elapsedNs(start);
+        benchSink = world.getHero().getCurrPos().x;
+        return ns;
+    });
+}
+
+#ifdef A5_BENCH_GL
+/// \desc uniform updates through CSCI441::ShaderProgram, which need a hidden window and context
+static void runGLBenchmarks( const BenchOptions& options ) {
+    const char* BY_NAME = "uniform.setByName";
+    const char* BY_LOCATION = "uniform.setByLocation";
+    if( !isSelected(options, BY_NAME) && !isSelected(options, BY_LOCATION) ) return;
+
+    GLFWwindow* pWindow = nullptr;
+    if( glfwInit() ) {
+        glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+        glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+        glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+        glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+        glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+        pWindow = glfwCreateWindow( 64, 64, "A5Bench", nullptr, nullptr );
+    }
+    if( pWindow == nullptr ) {
+        fprintf( stderr, "[WARN]: Could not create a hidden GL window, skipping the GL benchmarks\n" );
+        if( isSelected(options, BY_NAME) ) printRow( BY_NAME, 0, 0, 0.0, 0.0, "skipped" );
+        if( isSelected(options, BY_LOCATION) ) printRow( BY_LOCATION, 0, 0, 0.0, 0.0, "skipped" );
+        glfwTerminate();
+        return;
+    }
+    glfwMakeContextCurrent( pWindow );
+    glewExperimental = GL_TRUE;
+    glewInit();
+
+    // the same program and uniform the engine sets for every draw, found relative to the
+    // working directory just like the engine does
+    auto pProgram = new CSCI441::ShaderProgram( "shaders/A3.v.glsl", "shaders/A3.f.glsl" );
+    const GLint modelMatrixLocation = pProgram->getUniformLocation( "modelMatrix" );
+    if( modelMatrixLocation < 0 ) {
+        fprintf( stderr, "[WARN]: Could not build shaders/A3 from the working directory, skipping the GL benchmarks\n" );
+        if( isSelected(options, BY_NAME) ) printRow( BY_NAME, 0, 0, 0.0, 0.0, "skipped" );
+        if( isSelected(options, BY_LOCATION) ) printRow( BY_LOCATION, 0, 0, 0.0, 0.0, "skipped" );
+    } else {
+        pProgram->useProgram();
+        // glFinish makes the driver's deferred work count towards the run it came from
+        runBenchmark(options, BY_NAME, [&](GLuint iterations) {
+            glm::mat4 modelMtx(1.0f);
+            auto start = BenchClock::now();
+            for( GLuint i = 0; i < iterations; i++ ) {
+                modelMtx[3].x = (GLfloat)i;
+                pProgram->setProgramUniform( "modelMatrix", modelMtx );
+            }
+            glFinish();
+            return elapsedNs(start);
+        });
+        runBenchmark(options, BY_LOCATION, [&](GLuint iterations) {
+            glm::mat4 modelMtx(1.0f);
+            auto start = BenchClock::now();
+            for( GLuint i = 0; i < iterations; i++ ) {
+                modelMtx[3].x = (GLfloat)i;
+                pProgram->setProgramUniform( modelMatrixLocation, modelMtx );
+            }
+            glFinish();
+            return elapsedNs(start);
+        });
+    }
+
+    delete pProgram;
+    glfwDestroyWindow( pWindow );
+    glfwTerminate();
+}
+#endif
+
+/// \desc reads the command line, anything unrecognized prints the usage and exits
+static BenchOptions parseOptions( int argc, char* argv[] ) {
+    BenchOptions options = {5, 20.0, nullptr};
+    for( int i = 1; i < argc; i++ ) {
+        if( i + 1 < argc && strcmp(argv[i], "--runs") == 0 ) {
+            options.numRuns = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if( i + 1 < argc && strcmp(argv[i], "--min-run-ms") == 0 ) {
+            options.minRunMs = strtod(argv[++i], nullptr);
+        } else if( i + 1 < argc && strcmp(argv[i], "--filter") == 0 ) {
+            options.filter = argv[++i];
+        } else {
+            fprintf( stderr, "Usage: %s [--runs N] [--min-run-ms MS] [--filter TEXT]\n", argv[0] );
+            exit(EXIT_FAILURE);
+        }
+    }
+    if( options.numRuns == 0 ) {
+        fprintf( stderr, "[ERROR]: at least one run is needed\n" );
+        exit(EXIT_FAILURE);
+    }
+    return options;
+}
+
+///*****************************************************************************
+//
+// Our main function
+int main( int argc, char* argv[] ) {
+    const BenchOptions options = parseOptions(argc, argv);
+
+    fprintf( stdout, "benchmark,iterations,runs,min_ns_per_op,median_ns_per_op,status\n" );
+    runCoreBenchmarks(options);
+#ifdef A5_BENCH_GL
+    runGLBenchmarks(options);
+#endif
+
+    return EXIT_SUCCESS;
+}
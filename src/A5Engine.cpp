@@ -1,6 +1,9 @@
 #include "A5Engine.h"
+#include "Profiler.h"
 
-#include <CSCI441/objects.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
 
 //*************************************************************************************
 //
@@ -14,7 +17,7 @@
 //
 // Public Interface
 
-A5Engine::A5Engine()
+A5Engine::A5Engine(const GameWorld::Config& worldConfig)
          : CSCI441::OpenGLEngine(4, 1,
                                  1040, 880,
                                  "A3: The Cabin In The Woods") {
@@ -25,19 +28,56 @@ A5Engine::A5Engine()
     _currHeroHeight = 1.0f;
     _mousePosition = glm::vec2(MOUSE_UNINITIALIZED, MOUSE_UNINITIALIZED );
     _leftMouseButtonState = GLFW_RELEASE;
-    countTiles = 0;
-    enemy1Dead = false;
-    enemy2Dead = false;
+
+    // the world holds no GL state, so it can exist before the window does
+    _pWorld = new GameWorld(worldConfig);
+    _pSimulation = new SimulationThread(*_pWorld);
+    _pRecording = nullptr;
+    _stressFrames = 0;
+    _vsyncMode = FramePacer::VsyncMode::ON;
+    _lowLatencyLoop = false;
+
+    _lastPollTime = 0.0;
+    _cameraInputTime = NO_PENDING_INPUT;
+    _drawnCameraInputTime = NO_PENDING_INPUT;
+    _moveInputTime = NO_PENDING_INPUT;
+    _moveInputSequence = 0;
+    _moveInputHandedOver = false;
+    _drawnTickCount = 0;
+    _cameraLatencyZone = Profiler::instance().registerZone("latency.cameraToPresent");
+    _moveLatencyZone = Profiler::instance().registerZone("latency.moveToPresent");
 }
 
 A5Engine::~A5Engine() {
     delete _pArcCam;
+    delete _pSimulation;
+    delete _pWorld;
+    delete _pRecording;
+}
+
+void A5Engine::setRecordingFile(const char* filename) {
+    if (_pRecording == nullptr) {
+        _pRecording = new InputRecording();
+    }
+    _recordingFilename = filename;
+    _pSimulation->setRecording(_pRecording);
 }
 
 void A5Engine::handleKeyEvent(GLint key, GLint action) {
     if(key != GLFW_KEY_UNKNOWN)
         _keys[key] = ((action == GLFW_PRESS) || (action == GLFW_REPEAT));
 
+    // start timing how long pressing or releasing a control takes to reach the screen
+    if (action != GLFW_REPEAT) {
+        if ((key == GLFW_KEY_W || key == GLFW_KEY_S || key == GLFW_KEY_A || key == GLFW_KEY_D)
+            && _moveInputTime == NO_PENDING_INPUT) {
+            _moveInputTime = _lastPollTime;
+            _moveInputHandedOver = false;
+        } else if ((key == GLFW_KEY_R || key == GLFW_KEY_F) && _cameraInputTime == NO_PENDING_INPUT) {
+            _cameraInputTime = _lastPollTime;
+        }
+    }
+
     if(action == GLFW_PRESS ) {
         switch( key ) {
             // quit!
@@ -46,6 +86,27 @@ void A5Engine::handleKeyEvent(GLint key, GLint action) {
                 setWindowShouldClose();
                 break;
 
+            // report how much the frustum culling saved on the last frame
+            case GLFW_KEY_C:
+                fprintf(stdout, "[INFO]: Frustum culling - %u visible, %u culled\n", _culler.getVisibleCount(), _culler.getCulledCount());
+                fprintf(stdout, "[INFO]: Render queue - %u packets, %u draw calls\n", _renderQueue.getPacketCount(), _renderQueue.getDrawCallCount());
+                break;
+
+            // report how long each profiled zone has been taking
+            case GLFW_KEY_P:
+                Profiler::instance().printStats(stdout);
+                _framePacer.printStats(stdout);
+                break;
+
+            // save the recent timeline of every zone to open in about:tracing or Perfetto
+            case GLFW_KEY_T:
+                if (!TraceRecorder::instance().isEnabled()) {
+                    fprintf(stdout, "[INFO]: Tracing is off, start with --trace to record the timeline\n");
+                } else if (TraceRecorder::instance().writeJson(TRACE_FILENAME)) {
+                    fprintf(stdout, "[INFO]: Wrote trace to \"%s\"\n", TRACE_FILENAME);
+                }
+                break;
+
             default: break; // suppress CLion warning
         }
     }
@@ -69,6 +130,9 @@ void A5Engine::handleCursorPositionEvent(glm::vec2 currMousePosition) {
     if(_leftMouseButtonState == GLFW_PRESS) {
         // rotate the camera by the distance the mouse moved
         _pArcCam->rotate((currMousePosition.x - _mousePosition.x) * 0.005f, (_mousePosition.y - currMousePosition.y) * 0.005f );
+        if (_cameraInputTime == NO_PENDING_INPUT) {
+            _cameraInputTime = _lastPollTime;
+        }
     }
 
     // update the mouse position
@@ -86,6 +150,21 @@ void A5Engine::mSetupGLFW() {
     glfwSetKeyCallback(mpWindow, lab05_engine_keyboard_callback);
     glfwSetMouseButtonCallback(mpWindow, lab05_engine_mouse_button_callback);
     glfwSetCursorPosCallback(mpWindow, lab05_engine_cursor_callback);
+
+    // a stress run measures how long frames take to draw, not how long the display waits
+    if (_stressFrames > 0) {
+        _vsyncMode = FramePacer::VsyncMode::OFF;
+        _framePacer.setTargetFps(0.0);
+    }
+    // swapping late frames straight away needs the swap tear extension
+    if (_vsyncMode == FramePacer::VsyncMode::ADAPTIVE
+        && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+        && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        fprintf(stdout, "[INFO]: Adaptive vsync is not supported, using vsync instead\n");
+        _vsyncMode = FramePacer::VsyncMode::ON;
+    }
+    // never left to the driver's default, which differs from one machine to the next
+    glfwSwapInterval((GLint)_vsyncMode);
 }
 
 void A5Engine::mSetupOpenGL() {
@@ -100,46 +179,80 @@ void A5Engine::mSetupOpenGL() {
 
 void A5Engine::mSetupShaders() {
     _lightingShaderProgram = new CSCI441::ShaderProgram("shaders/A3.v.glsl", "shaders/A3.f.glsl" );
-    _lightingShaderUniformLocations.mvpMatrix      = _lightingShaderProgram->getUniformLocation("mvpMatrix");
+    _lightingShaderUniformLocations.modelMatrix    = _lightingShaderProgram->getUniformLocation("modelMatrix");
     _lightingShaderUniformLocations.materialColor  = _lightingShaderProgram->getUniformLocation("materialColor");
-    // TODO #3A: assign uniforms
-    _lightingShaderUniformLocations.normalMatrix = _lightingShaderProgram->getUniformLocation("normalMatrix");
-    _lightingShaderUniformLocations.lightDirection = _lightingShaderProgram->getUniformLocation("lightDirection");
-    _lightingShaderUniformLocations.lightColor = _lightingShaderProgram->getUniformLocation("lightColor");
+    _lightingShaderProgram->setUniformBlockBinding("FrameData", FRAME_DATA_BINDING);
 
     _lightingShaderAttributeLocations.vPos         = _lightingShaderProgram->getAttributeLocation("vPos");
-    // TODO #3B: assign attributes
     _lightingShaderAttributeLocations.vertexNormal = _lightingShaderProgram->getAttributeLocation("vertexNormal");
-
+    _lightingShaderAttributeLocations.vertexColor  = _lightingShaderProgram->getAttributeLocation("vertexColor");
+
+    _instancedShaderProgram = new CSCI441::ShaderProgram("shaders/A5Instanced.v.glsl", "shaders/A3.f.glsl" );
+    _instancedShaderProgram->setUniformBlockBinding("FrameData", FRAME_DATA_BINDING);
+
+    _instancedShaderAttributeLocations.vPos                 = _instancedShaderProgram->getAttributeLocation("vPos");
+    _instancedShaderAttributeLocations.vertexNormal         = _instancedShaderProgram->getAttributeLocation("vertexNormal");
+    _instancedShaderAttributeLocations.instanceModelMatrix  = _instancedShaderProgram->getAttributeLocation("instanceModelMatrix");
+    _instancedShaderAttributeLocations.instanceNormalMatrix = _instancedShaderProgram->getAttributeLocation("instanceNormalMatrix");
+    _instancedShaderAttributeLocations.instanceColor        = _instancedShaderProgram->getAttributeLocation("instanceColor");
+
+    _hordeShaderProgram = new CSCI441::ShaderProgram("shaders/A5Horde.v.glsl", "shaders/A3.f.glsl" );
+    _hordeShaderProgram->setUniformBlockBinding("FrameData", FRAME_DATA_BINDING);
+
+    _hordeShaderAttributeLocations.vPos                    = _hordeShaderProgram->getAttributeLocation("vPos");
+    _hordeShaderAttributeLocations.vertexNormal            = _hordeShaderProgram->getAttributeLocation("vertexNormal");
+    _hordeShaderAttributeLocations.vertexColor             = _hordeShaderProgram->getAttributeLocation("vertexColor");
+    _hordeShaderAttributeLocations.instancePositionHeading = _hordeShaderProgram->getAttributeLocation("instancePositionHeading");
+    _hordeShaderAttributeLocations.instanceScale           = _hordeShaderProgram->getAttributeLocation("instanceScale");
+    _hordeShaderAttributeLocations.instanceColor           = _hordeShaderProgram->getAttributeLocation("instanceColor");
 }
 
 void A5Engine::mSetupBuffers() {
-    // TODO #4: need to connect our 3D Object Library to our shader
-    CSCI441::setVertexAttributeLocations( _lightingShaderAttributeLocations.vPos, _lightingShaderAttributeLocations.vertexNormal );
-
-    // TODO #5: give the hero the normal matrix location
-    _pHero = new Hero(_lightingShaderProgram->getShaderProgramHandle(),
-                      _lightingShaderUniformLocations.mvpMatrix,
-                      _lightingShaderUniformLocations.normalMatrix,
-                      _lightingShaderUniformLocations.materialColor);
-
-    _pEnemy1 = new Enemy(_lightingShaderProgram->getShaderProgramHandle(),
-                      _lightingShaderUniformLocations.mvpMatrix,
-                      _lightingShaderUniformLocations.normalMatrix,
-                      _lightingShaderUniformLocations.materialColor);
-
-    _pEnemy2 = new Enemy(_lightingShaderProgram->getShaderProgramHandle(),
-                         _lightingShaderUniformLocations.mvpMatrix,
-                         _lightingShaderUniformLocations.normalMatrix,
-                         _lightingShaderUniformLocations.materialColor);
-
-    _pWalls = new Walls(_lightingShaderProgram->getShaderProgramHandle(),
-                      _lightingShaderUniformLocations.mvpMatrix,
-                      _lightingShaderUniformLocations.normalMatrix,
-                      _lightingShaderUniformLocations.materialColor);
-
-    // get hero position for cam look at.
-    _currHeroPos = _pHero->getCurrPos();
+    // meshes without per-vertex colors (ground, walls) fall back to white so only their material color shows
+    glVertexAttrib3f( _lightingShaderAttributeLocations.vertexColor, 1.0f, 1.0f, 1.0f );
+
+    // programs sort in the order they are registered
+    _renderQueue.registerProgram(_lightingShaderProgram->getShaderProgramHandle(),
+                                 _lightingShaderUniformLocations.modelMatrix,
+                                 _lightingShaderUniformLocations.materialColor);
+    _renderQueue.registerProgram(_instancedShaderProgram->getShaderProgramHandle(), -1, -1);
+    _renderQueue.registerProgram(_hordeShaderProgram->getShaderProgramHandle(), -1, -1);
+
+    _pHeroRenderer = new HeroRenderer(_lightingShaderProgram->getShaderProgramHandle(),
+                                      _pWorld->getHero(),
+                                      _lightingShaderAttributeLocations.vPos,
+                                      _lightingShaderAttributeLocations.vertexNormal,
+                                      _lightingShaderAttributeLocations.vertexColor);
+
+    // every enemy shares the same parts, only their root transforms and head colors differ
+    _pHordeRenderer = new HordeRenderer(_hordeShaderProgram->getShaderProgramHandle(),
+                                        Enemy(),
+                                        _hordeShaderAttributeLocations.vPos,
+                                        _hordeShaderAttributeLocations.vertexNormal,
+                                        _hordeShaderAttributeLocations.vertexColor,
+                                        _hordeShaderAttributeLocations.instancePositionHeading,
+                                        _hordeShaderAttributeLocations.instanceScale,
+                                        _hordeShaderAttributeLocations.instanceColor);
+
+    _pWallRenderer = new WallRenderer(_lightingShaderProgram->getShaderProgramHandle(),
+                                      _pWorld->getWalls(),
+                                      _lightingShaderAttributeLocations.vPos,
+                                      _lightingShaderAttributeLocations.vertexNormal);
+
+    _pSceneGpuTimer = new GpuTimer("gpu.scene");
+
+    _pTileRenderer = new TileRenderer(_instancedShaderProgram->getShaderProgramHandle(),
+                                      _instancedShaderAttributeLocations.vPos,
+                                      _instancedShaderAttributeLocations.vertexNormal,
+                                      _instancedShaderAttributeLocations.instanceModelMatrix,
+                                      _instancedShaderAttributeLocations.instanceNormalMatrix,
+                                      _instancedShaderAttributeLocations.instanceColor);
+
+    // per-frame uniform buffer shared by every shader
+    glGenBuffers(1, &_frameDataUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, _frameDataUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, _frameDataUBO);
 
     _createGroundBuffers();
     _generateEnvironment();
@@ -184,72 +297,30 @@ void A5Engine::_createGroundBuffers() {
 }
 
 void A5Engine::_generateEnvironment() {
-    //******************************************************************
-    // parameters to make up our grid size and spacing, feel free to
-    // play around with this
-    const GLfloat GRID_WIDTH = 1.0f;
-    const GLfloat GRID_LENGTH = 1.0f;
-    const GLfloat GRID_SPACING_WIDTH = 1.0f;
-    const GLfloat GRID_SPACING_LENGTH = 1.0f;
-    // precomputed parameters based on above
-    const GLfloat LEFT_END_POINT = -GRID_WIDTH / 2.0f - 5.0f;
-    const GLfloat RIGHT_END_POINT = GRID_WIDTH / 2.0f + 5.0f;
-    const GLfloat BOTTOM_END_POINT = -GRID_LENGTH / 2.0f - 5.0f;
-    const GLfloat TOP_END_POINT = GRID_LENGTH / 2.0f + 5.0f;
-    //******************************************************************
-
-    srand( time(0) );                                                   // seed our RNG
-
-    // psych! everything's on a grid.
-    for(int i = LEFT_END_POINT; i < RIGHT_END_POINT; i += GRID_SPACING_WIDTH) {
-        for(int j = BOTTOM_END_POINT; j < TOP_END_POINT; j += GRID_SPACING_LENGTH) {
-            // don't just draw a tiles ANYWHERE.
-            if( i % 2 && j % 2 ) {
-                // translate to spot
-                glm::mat4 transToSpotMtx = glm::translate( glm::mat4(1.0), glm::vec3(i, 0.0f, j) );
-
-                // compute height
-                GLdouble height = 0.3f;
-                // scale to tile size
-                glm::mat4 scaleToHeightMtx = glm::scale( glm::mat4(1.0), glm::vec3(9, height, 9) );
-
-                // translate up to grid
-                glm::mat4 transToHeight = glm::translate( glm::mat4(1.0), glm::vec3(0, height/2.0f, 0) );
-
-                // compute full model matrix
-                glm::mat4 modelMatrix = transToHeight * scaleToHeightMtx * transToSpotMtx;
-
-                // compute color
-                glm::vec3 color( 0.4f, 0.4f, 0.4f );
-                // store tile properties
-                TileData currentTile = {modelMatrix, color,glm::vec3(i*9, 0.0f, j*9)};
-                _tiles.emplace_back(currentTile);
-            }
-        }
-    }
+    // hand every tile to the GPU once, only colors get patched after this
+    std::vector<glm::mat4> tileModelMatrices;
+    std::vector<glm::vec3> tileColors;
+    for( const GameWorld::Tile& currentTile : _pWorld->getTiles() ) {
+        tileModelMatrices.emplace_back(currentTile.modelMatrix);
+        tileColors.emplace_back(currentTile.color);
+    }
+    _pTileRenderer->setTiles(tileModelMatrices, tileColors);
 }
 
 void A5Engine::mSetupScene() {
 
     // Initialize Arcball Cam
-    _pArcCam = new CSCI441::ArcballCam(5.0f, 15.0f);
+    _pArcCam = new CSCI441::ArcballCam(MIN_OCCLUDED_CAMERA_RADIUS, MAX_CAMERA_RADIUS);
     _pArcCam->setTheta(0.0f );
     _pArcCam->setPhi(1.9f );
-    _pArcCam->setRadius( 10.0f );
-    _pArcCam->setLookAtPoint(_currHeroPos + glm::vec3(0.0, _currHeroHeight, 0.0));
+    _cameraRadius = 10.0f;
+    _pArcCam->setRadius( _cameraRadius );
+    _pArcCam->setLookAtPoint(_pWorld->getHero().getCurrPos() + glm::vec3(0.0, _currHeroHeight, 0.0));
     _pArcCam->recomputeOrientation();
 
-    // TODO #6: set lighting uniforms
-    glm::vec3 lightDirection(1.0f, -1.0f, 1.0f);
-    glm::vec3 lightColor(1.0f,1.0f,1.0f);
-    glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.lightDirection, 1, &lightDirection[0]);
-    glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.lightColor, 1, &lightColor[0]);
-
-    _pEnemy1->setEnemyPosition(glm::vec3(45, 0, -45));
-    _pEnemy2->setEnemyPosition(glm::vec3(-45, 0, 45));
-
-    _pEnemy1->setEnemyHeading(_pEnemy1->getHeading() + _pEnemy1->getBodyAngleFactor() * 64);
-    _pEnemy2->setEnemyHeading(_pEnemy2->getHeading() + _pEnemy2->getBodyAngleFactor() * 32);
+    // lighting is uploaded with the rest of the per-frame data
+    _lightDirection = glm::vec3(1.0f, -1.0f, 1.0f);
+    _lightColor = glm::vec3(1.0f,1.0f,1.0f);
 }
 
 //*************************************************************************************
@@ -259,202 +330,139 @@ void A5Engine::mSetupScene() {
 void A5Engine::mCleanupShaders() {
     fprintf( stdout, "[INFO]: ...deleting Shaders.\n" );
     delete _lightingShaderProgram;
+    delete _instancedShaderProgram;
+    delete _hordeShaderProgram;
 }
 
 void A5Engine::mCleanupBuffers() {
     fprintf( stdout, "[INFO]: ...deleting VAOs....\n" );
-    CSCI441::deleteObjectVAOs();
     glDeleteVertexArrays( 1, &_groundVAO );
 
-    fprintf( stdout, "[INFO]: ...deleting VBOs....\n" );
-    CSCI441::deleteObjectVBOs();
+    fprintf( stdout, "[INFO]: ...deleting UBOs....\n" );
+    glDeleteBuffers( 1, &_frameDataUBO );
 
     fprintf( stdout, "[INFO]: ...deleting models..\n" );
-    delete _pHero;
-    delete _pWalls;
+    delete _pHeroRenderer;
+    delete _pWallRenderer;
+    delete _pTileRenderer;
+    delete _pHordeRenderer;
+    delete _pSceneGpuTimer;
 }
 
 //*************************************************************************************
 //
 // Rendering / Drawing Functions - this is where the magic happens!
 
-void A5Engine::_renderScene(glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    // use our lighting shader program
-    _lightingShaderProgram->useProgram();
+void A5Engine::_renderScene(const WorldSnapshot& snapshot, glm::mat4 viewMtx, glm::mat4 projMtx, GLfloat alpha) {
+    // camera and light are shared by everything drawn this frame
+    _uploadFrameData(viewMtx, projMtx);
+    _culler.beginFrame(projMtx * viewMtx);
+    _lod.beginFrame(viewMtx, projMtx);
+    _renderQueue.beginFrame(viewMtx);
 
     //// BEGIN DRAWING THE GROUND PLANE ////
     // draw the ground plane
-    glm::mat4 groundModelMtx = glm::scale( glm::mat4(1.0f), glm::vec3(WORLD_SIZE, 1.0f, WORLD_SIZE));
-    _computeAndSendMatrixUniforms(groundModelMtx, viewMtx, projMtx);
-
+    glm::mat4 groundModelMtx = glm::scale( glm::mat4(1.0f), glm::vec3(_pWorld->getWorldSize(), 1.0f, _pWorld->getWorldSize()));
     glm::vec3 groundColor(0.9f, 0.9f, 0.9f);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, groundColor);
-
-    glBindVertexArray(_groundVAO);
-    glDrawElements(GL_TRIANGLE_STRIP, _numGroundPoints, GL_UNSIGNED_SHORT, (void*)0);
+    _renderQueue.submit( {_lightingShaderProgram->getShaderProgramHandle(), _groundVAO, GL_TRIANGLE_STRIP, GL_UNSIGNED_SHORT, _numGroundPoints, 0, 0, groundModelMtx, groundColor} );
     //// END DRAWING THE GROUND PLANE ////
 
-    //// BEGIN DRAWING THE TILES ////
-    for( const TileData& currentTile : _tiles ) {
-        _computeAndSendMatrixUniforms(currentTile.modelMatrix, viewMtx, projMtx);
-
-        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, currentTile.color);
-
-        CSCI441::drawSolidCube(1.0);
-    }
-    //// END DRAWING THE TILES ////
-
     //// BEGIN DRAWING THE HERO ////
     glm::mat4 modelMtx(1.0f);
-    _pHero->drawHero(modelMtx, viewMtx, projMtx);
-    if (_pHero->getFalling()) {
-        _pHero->setHeroPosition(_pHero->getCurrPos() - glm::vec3(0, 0.3f, 0));
-    }
+    _pHeroRenderer->submitHero(snapshot.hero, modelMtx, _culler, _lod, _renderQueue, alpha);
     //// END DRAWING THE HERO ////
 
-    //// BEGIN DRAWING THE ENEMIES ////
-    if (!enemy1Dead) {
-        _pEnemy1->drawEnemy(modelMtx, viewMtx, projMtx);
-        if (_pEnemy1->getFalling()) {
-            _pEnemy1->setEnemyPosition(_pEnemy1->getCurrPos() - glm::vec3(0, 0.3f, 0));
-        }
-    }
-
-    if (!enemy2Dead) {
-        _pEnemy2->drawEnemy(modelMtx, viewMtx, projMtx);
-        if (_pEnemy2->getFalling()) {
-            _pEnemy2->setEnemyPosition(_pEnemy2->getCurrPos() - glm::vec3(0, 0.3f, 0));
-        }
-    }
-    //// END DRAWING THE ENEMIES ////
-
     //// BEGIN DRAWING THE WALLS ////
-    _pWalls->drawWalls(modelMtx, viewMtx, projMtx);
+    _pWallRenderer->submitWalls(modelMtx, _culler, _renderQueue);
     //// END DRAWING THE WALLS ////
-}
 
-void A5Engine::_updateScene() {
-    // Handle the hero's forward movement and checks for environment boundaries.
-    if(_keys[GLFW_KEY_W]) {
-        _pHero->moveForward();
-        isCollisionForward(_pHero->getCurrPos(), _pWalls->getNorthWallPosition(), _pWalls->getEastWallPosition(), _pWalls->getSouthWallPosition(), _pWalls->getWestWallPosition());
-        if(_pHero->getCurrPos().x > 55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().x < -55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().z > 55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().z < -55.0f) {
-            _pHero->setFalling(true);
+    //// BEGIN DRAWING THE TILES ////
+    // only the tiles the hero stepped on since the last drawn snapshot get their color patched,
+    // and a snapshot drawn again has nothing new to patch
+    if (snapshot.tickCount != _drawnTickCount) {
+        for (const WorldSnapshot::TileChange& change : snapshot.changedTiles) {
+            _pTileRenderer->setTileColor(change.tile, change.color);
         }
+        _drawnTickCount = snapshot.tickCount;
     }
+    _pTileRenderer->submitTiles(_culler, _renderQueue);
+    //// END DRAWING THE TILES ////
 
-    // Handle the hero's backward movement and checks for environment boundaries.
-    if(_keys[GLFW_KEY_S]) {
-        _pHero->moveBackward();
-        isCollisionBackward(_pHero->getCurrPos(), _pWalls->getNorthWallPosition(), _pWalls->getEastWallPosition(), _pWalls->getSouthWallPosition(), _pWalls->getWestWallPosition());
-        if(_pHero->getCurrPos().x > 55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().x < -55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().z > 55.0f) {
-            _pHero->setFalling(true);
-        }
-        if(_pHero->getCurrPos().z < -55.0f) {
-            _pHero->setFalling(true);
-        }
-    }
+    //// BEGIN DRAWING THE ENEMIES ////
+    _pHordeRenderer->submitHorde(snapshot.enemies, _culler, _lod, _renderQueue, alpha);
+    //// END DRAWING THE ENEMIES ////
 
-    // Rotates the hero's heading left or right.
-    if(_keys[GLFW_KEY_D]) {
-        _pHero->turnRight();
-    }
+    // sorts everything queued above by program, mesh, material and depth and draws it
+    _renderQueue.flush();
+}
 
-    if(_keys[GLFW_KEY_A]) {
-        _pHero->turnLeft();
+void A5Engine::_updateInput(GLdouble frameTime) {
+    // the simulation thread only sees which controls are held, every game rule runs there
+    GameWorld::Input input = {
+            (bool)_keys[GLFW_KEY_W],
+            (bool)_keys[GLFW_KEY_S],
+            (bool)_keys[GLFW_KEY_A],
+            (bool)_keys[GLFW_KEY_D]
+    };
+    const GLuint inputSequence = _pSimulation->setInput(input);
+    // the movement shows once a snapshot stepped with this sequence number is drawn
+    if (_moveInputTime != NO_PENDING_INPUT && !_moveInputHandedOver) {
+        _moveInputSequence = inputSequence;
+        _moveInputHandedOver = true;
     }
 
-    // Zoom arcball cam in/out
+    // Zoom arcball cam in/out, at the same speed the old per-tick zoom had
+    const auto zoom = (GLfloat)(0.2 * frameTime * FixedTimestep::REFERENCE_TICK_RATE);
     if ( _keys[GLFW_KEY_R]) {
-        _pArcCam->moveForward(0.2f);
+        _cameraRadius = glm::max(_cameraRadius - zoom, MIN_CAMERA_RADIUS);
     }
     if ( _keys[GLFW_KEY_F]) {
-        _pArcCam->moveBackward(0.2f);
+        _cameraRadius = glm::min(_cameraRadius + zoom, MAX_CAMERA_RADIUS);
     }
-
-    // Create hero and enemy idle movements.
-    _pHero->idleMovement();
-    isOnTile(_pHero->getCurrPos());
-    isWinner();
-
-    _pEnemy1->idleMovement();
-    _pEnemy2->idleMovement();
-
-    // Check if the hero has fallen off the map a certain amount to close the game.
-    if ( _pHero->getCurrPos().y < -50.0f ) {
-        setWindowShouldClose();
-    }
-
-    // Creates the Enemy following the hero where ever he goes by checking the direction.
-    enemy1DirectionToHero = _pHero->getCurrPos() - _pEnemy1->getCurrPos();
-    enemy2DirectionToHero = _pHero->getCurrPos() - _pEnemy2->getCurrPos();
-
-    enemy1DirectionToHero = normalize(enemy1DirectionToHero);
-    enemy2DirectionToHero = normalize(enemy2DirectionToHero);
-
-    _pEnemy1->setEnemyHeading(atan2(-enemy1DirectionToHero.z, enemy1DirectionToHero.x));
-    _pEnemy1->moveForward();
-    _pEnemy2->setEnemyHeading(atan2(-enemy2DirectionToHero.z, enemy2DirectionToHero.x));
-    _pEnemy2->moveForward();
-
-    // Checks for any collisions.
-    isCollisionForwardEnemy1(_pEnemy1->getCurrPos(), _pWalls->getNorthWallPosition(), _pWalls->getEastWallPosition(), _pWalls->getSouthWallPosition(), _pWalls->getWestWallPosition());
-    isCollisionForwardEnemy2(_pEnemy2->getCurrPos(), _pWalls->getNorthWallPosition(), _pWalls->getEastWallPosition(), _pWalls->getSouthWallPosition(), _pWalls->getWestWallPosition());
-    isCollisionEnemies(_pEnemy1->getCurrPos(), _pEnemy2->getCurrPos());
-    isCollisionEnemyHero(_pEnemy1->getCurrPos(), _pEnemy2->getCurrPos(), _pHero->getCurrPos());
-
-    // Makes sure the enemy can fall off the map the same way the hero can.
-    if(_pEnemy1->getCurrPos().x > 55.0f) {
-        _pEnemy1->setFalling(true);
-    }
-    if(_pEnemy1->getCurrPos().x < -55.0f) {
-        _pEnemy1->setFalling(true);
-    }
-    if(_pEnemy1->getCurrPos().z > 55.0f) {
-        _pEnemy1->setFalling(true);
-    }
-    if(_pEnemy1->getCurrPos().z < -55.0f) {
-        _pEnemy1->setFalling(true);
-    }
-
-    if(_pEnemy2->getCurrPos().x > 55.0f) {
-        _pEnemy2->setFalling(true);
-    }
-    if(_pEnemy2->getCurrPos().x < -55.0f) {
-        _pEnemy2->setFalling(true);
-    }
-    if(_pEnemy2->getCurrPos().z > 55.0f) {
-        _pEnemy2->setFalling(true);
-    }
-    if(_pEnemy2->getCurrPos().z < -55.0f) {
-        _pEnemy2->setFalling(true);
-    }
-
-    //// BEGIN UPDATING CAMERAS ////
-    _updateCamPosition();
-    //// END UPDATING CAMERAS ////
 }
 
 void A5Engine::run() {
     //  This is our draw loop - all rendering is done here.  We use a loop to keep the window open
     //	until the user decides to close the window and quit the program.  Without a loop, the
     //	window will display once and then the program exits.
+    // the game rules run on their own thread so a slow swap never holds up a tick
+    TraceRecorder::instance().setThreadName("render");
+    _pSimulation->start();
+    _lastPollTime = glfwGetTime();
+
+    const bool isStressRun = _stressFrames > 0;
+    if (isStressRun) {
+        const GameWorld::Config& config = _pWorld->getConfig();
+        fprintf(stdout, "[INFO]: Stress run of %u frames - seed %u, %u enemies, %ux%u tiles, %u walls\n",
+                _stressFrames, config.seed, config.numEnemies, config.tileColumns, config.tileRows, config.numWalls);
+        _stressFrameTimes.reserve(_stressFrames);
+    }
+
+    GLuint frameNumber = 0;
+    GLdouble previousTime = glfwGetTime();
     while( !glfwWindowShouldClose(mpWindow) ) {	        // check if the window was instructed to be closed
+        {
+            // waiting before the input is read rather than after the swap keeps the input fresh
+            A5_PROFILE_SCOPE("frame.pacing");
+            _framePacer.wait();
+        }
+        TraceRecorder::instance().markFrame(frameNumber++);
+        A5_PROFILE_SCOPE("frame");
+        // input polled now reaches the screen this frame instead of waiting out a whole frame
+        if (_lowLatencyLoop) {
+            _pollEvents();
+        }
+        GLdouble currentTime = glfwGetTime();
+        _updateInput(currentTime - previousTime);
+        // the first frame has no previous frame to be measured against
+        if (isStressRun && frameNumber > 1) {
+            _stressFrameTimes.push_back((currentTime - previousTime) * 1000.0);
+            if (--_stressFrames == 0) {
+                setWindowShouldClose();
+            }
+        }
+        previousTime = currentTime;
+
         glDrawBuffer( GL_BACK );				        // work with our back frame buffer
         glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );	// clear the current color contents and depth buffer in the window
 
@@ -466,226 +474,119 @@ void A5Engine::run() {
 
         // update the viewport - tell OpenGL we want to render to the whole window
         glViewport( 0, 0, framebufferWidth, framebufferHeight );
+        _lod.setViewportHeight( framebufferHeight );
+
+        // draw the newest tick the simulation has published, it cannot change underneath us.  The
+        // snapshot and camera are latched as late as possible, right before the scene is submitted
+        const WorldSnapshot& snapshot = _pSimulation->acquireSnapshot();
+        // Close the game once the hero has fallen off the map or been shrunk away.
+        // A stress run keeps drawing the scene until its frames are up.
+        if ( snapshot.finished && !isStressRun ) {
+            setWindowShouldClose();
+        }
+        // time since that tick, rendering blends the snapshot's last two ticks by it
+        GLfloat alpha = _pSimulation->getAlpha(snapshot);
 
-        // draw everything to the window
-        _renderScene(_pArcCam->getViewMatrix(), _pArcCam->getProjectionMatrix());
-
-        _updateScene();
-
-        glfwSwapBuffers(mpWindow);                       // flush the OpenGL commands and make sure they get rendered!
-        glfwPollEvents();				                // check for any events and signal to redraw screen
-    }
-}
-
-//*************************************************************************************
-//
-// Private Helper FUnctions
-
-void A5Engine::_updateCamPosition() {
-    glm::vec3 lookAtPoint = _pHero->getCurrPos() + glm::vec3(0.0, 2.0, 0.0);
+        //// BEGIN UPDATING CAMERAS ////
+        _updateCamPosition(snapshot.hero, alpha);
+        // camera input handled so far is in the view matrix this frame is drawn with
+        _drawnCameraInputTime = _cameraInputTime;
+        _cameraInputTime = NO_PENDING_INPUT;
+        //// END UPDATING CAMERAS ////
 
-    _pArcCam->setLookAtPoint(lookAtPoint);
-    _pArcCam->recomputeOrientation();
-}
-
-// Checks for tile collision to count up for the game and creates the goal of the game.
-void A5Engine::isOnTile(glm::vec3 currPos) {
-    for (TileData& currentTile : _tiles) {
-        if (currPos.x > (currentTile._tileLocations.x - 4.5) && currPos.x < (currentTile._tileLocations.x + 4.5) && currPos.z > (currentTile._tileLocations.z - 4.5) && currPos.z < (currentTile._tileLocations.z + 4.5)) {
-            currentTile.color = glm::vec3(0.0, 1.0, 0.0);
+        // draw everything to the window
+        {
+            A5_PROFILE_SCOPE("render.scene");
+            _pSceneGpuTimer->begin();
+            _renderScene(snapshot, _pArcCam->getViewMatrix(), _pArcCam->getProjectionMatrix(), alpha);
+            _pSceneGpuTimer->end();
         }
-    }
-}
 
-// Creates how the hero grows in size and kills the enemies if the hero has visited all tiles.
-void A5Engine::isWinner() {
-    for ( TileData& currentTile : _tiles ) {
-        if ( currentTile.color.y == 1.0 ) {
-            countTiles += 1;
+        {
+            A5_PROFILE_SCOPE("render.swapBuffers");
+            glfwSwapBuffers(mpWindow);                   // flush the OpenGL commands and make sure they get rendered!
         }
-    }
-    if ( countTiles == 36 ) {
-        _pHero->setHeroWinner();
-        enemy1Dead = true;
-        enemy2Dead = true;
-        if ( _pHero->getBodySize().x > 15.0f ) {
-            _pHero->setHeroSize();
+        _recordInputLatency(snapshot);
+        if (!_lowLatencyLoop) {
+            _pollEvents();
         }
-    } else {
-        countTiles = 0;
-    }
-}
-
-// Creates the hero shrinking and closing the game if he gets touched by the enemy too much.
-void A5Engine::isLoser() {
-    _pHero->setHeroLoser();
-    if ( _pHero->getBodySize().x < 1.0f ) {
-        setWindowShouldClose();
-    }
-}
-
-// Checks all the collisions for walls and hero and enemies.
-void A5Engine::isCollisionForward(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall) {
-    if (currPos.x > (northWall.x - 1.5) && currPos.x < (northWall.x + 1.5) && currPos.z > (northWall.z - 31.5) && currPos.z < (northWall.z + 31.5)) {
-        _pHero->moveBackward();
-    }
-
-    if (currPos.x > (eastWall.x - 31.5) && currPos.x < (eastWall.x + 31.5) && currPos.z > (eastWall.z - 1.5) && currPos.z < (eastWall.z + 1.5)) {
-        _pHero->moveBackward();
-    }
-
-    if (currPos.x > (southWall.x - 1.5) && currPos.x < (southWall.x + 1.5) && currPos.z > (southWall.z - 31.5) && currPos.z < (southWall.z + 31.5)) {
-        _pHero->moveBackward();
     }
 
-    if (currPos.x > (westWall.x - 31.5) && currPos.x < (westWall.x + 31.5) && currPos.z > (westWall.z - 1.5) && currPos.z < (westWall.z + 1.5)) {
-        _pHero->moveBackward();
-    }
+    _pSimulation->stop();
 
-    if (currPos.x > ((northWall.x / 2) - 1.5) && currPos.x < ((northWall.x / 2) + 1.5) && currPos.z > ((northWall.z / 2) - 13.5) && currPos.z < ((northWall.z / 2) + 13.5)) {
-        _pHero->moveBackward();
+    if (isStressRun) {
+        _printStressReport();
     }
+    _framePacer.printStats(stdout);
 
-    if (currPos.x > ((eastWall.x / 2) - 13.5) && currPos.x < ((eastWall.x / 2) + 13.5) && currPos.z > ((eastWall.z / 2) - 1.5) && currPos.z < ((eastWall.z / 2) + 1.5)) {
-        _pHero->moveBackward();
+    if (Profiler::instance().writeCsv(PROFILE_FILENAME)) {
+        fprintf(stdout, "[INFO]: Wrote zone timings to \"%s\"\n", PROFILE_FILENAME);
     }
-
-    if (currPos.x > ((southWall.x / 2) - 1.5) && currPos.x < ((southWall.x / 2) + 1.5) && currPos.z > ((southWall.z / 2) - 13.5) && currPos.z < ((southWall.z / 2) + 13.5)) {
-        _pHero->moveBackward();
+    if (TraceRecorder::instance().isEnabled() && TraceRecorder::instance().writeJson(TRACE_FILENAME)) {
+        fprintf(stdout, "[INFO]: Wrote trace to \"%s\"\n", TRACE_FILENAME);
     }
 
-    if (currPos.x > ((westWall.x / 2) - 13.5) && currPos.x < ((westWall.x / 2) + 13.5) && currPos.z > ((westWall.z / 2) - 1.5) && currPos.z < ((westWall.z / 2) + 1.5)) {
-        _pHero->moveBackward();
+    if (_pRecording != nullptr && _pRecording->save(_recordingFilename.c_str())) {
+        fprintf(stdout, "[INFO]: Recorded %u ticks to \"%s\"\n", _pRecording->getNumTicks(), _recordingFilename.c_str());
     }
 }
 
-void A5Engine::isCollisionForwardEnemy1(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall) {
-    if (currPos.x > (northWall.x - 1.5) && currPos.x < (northWall.x + 1.5) && currPos.z > (northWall.z - 31.5) && currPos.z < (northWall.z + 31.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > (eastWall.x - 31.5) && currPos.x < (eastWall.x + 31.5) && currPos.z > (eastWall.z - 1.5) && currPos.z < (eastWall.z + 1.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > (southWall.x - 1.5) && currPos.x < (southWall.x + 1.5) && currPos.z > (southWall.z - 31.5) && currPos.z < (southWall.z + 31.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > (westWall.x - 31.5) && currPos.x < (westWall.x + 31.5) && currPos.z > (westWall.z - 1.5) && currPos.z < (westWall.z + 1.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > ((northWall.x / 2) - 1.5) && currPos.x < ((northWall.x / 2) + 1.5) && currPos.z > ((northWall.z / 2) - 13.5) && currPos.z < ((northWall.z / 2) + 13.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > ((eastWall.x / 2) - 13.5) && currPos.x < ((eastWall.x / 2) + 13.5) && currPos.z > ((eastWall.z / 2) - 1.5) && currPos.z < ((eastWall.z / 2) + 1.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > ((southWall.x / 2) - 1.5) && currPos.x < ((southWall.x / 2) + 1.5) && currPos.z > ((southWall.z / 2) - 13.5) && currPos.z < ((southWall.z / 2) + 13.5)) {
-        _pEnemy1->moveBackward();
-    }
-
-    if (currPos.x > ((westWall.x / 2) - 13.5) && currPos.x < ((westWall.x / 2) + 13.5) && currPos.z > ((westWall.z / 2) - 1.5) && currPos.z < ((westWall.z / 2) + 1.5)) {
-        _pEnemy1->moveBackward();
-    }
-}
-
-void A5Engine::isCollisionForwardEnemy2(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall) {
-    if (currPos.x > (northWall.x - 1.5) && currPos.x < (northWall.x + 1.5) && currPos.z > (northWall.z - 31.5) && currPos.z < (northWall.z + 31.5)) {
-        _pEnemy2->moveBackward();
-    }
-
-    if (currPos.x > (eastWall.x - 31.5) && currPos.x < (eastWall.x + 31.5) && currPos.z > (eastWall.z - 1.5) && currPos.z < (eastWall.z + 1.5)) {
-        _pEnemy2->moveBackward();
-    }
-
-    if (currPos.x > (southWall.x - 1.5) && currPos.x < (southWall.x + 1.5) && currPos.z > (southWall.z - 31.5) && currPos.z < (southWall.z + 31.5)) {
-        _pEnemy2->moveBackward();
-    }
-
-    if (currPos.x > (westWall.x - 31.5) && currPos.x < (westWall.x + 31.5) && currPos.z > (westWall.z - 1.5) && currPos.z < (westWall.z + 1.5)) {
-        _pEnemy2->moveBackward();
-    }
-
-    if (currPos.x > ((northWall.x / 2) - 1.5) && currPos.x < ((northWall.x / 2) + 1.5) && currPos.z > ((northWall.z / 2) - 13.5) && currPos.z < ((northWall.z / 2) + 13.5)) {
-        _pEnemy2->moveBackward();
-    }
+//*************************************************************************************
+//
+// Private Helper FUnctions
 
-    if (currPos.x > ((eastWall.x / 2) - 13.5) && currPos.x < ((eastWall.x / 2) + 13.5) && currPos.z > ((eastWall.z / 2) - 1.5) && currPos.z < ((eastWall.z / 2) + 1.5)) {
-        _pEnemy2->moveBackward();
-    }
+void A5Engine::_updateCamPosition(const Hero& hero, GLfloat alpha) {
+    glm::vec3 lookAtPoint = hero.getRenderPos(alpha) + glm::vec3(0.0, 2.0, 0.0);
 
-    if (currPos.x > ((southWall.x / 2) - 1.5) && currPos.x < ((southWall.x / 2) + 1.5) && currPos.z > ((southWall.z / 2) - 13.5) && currPos.z < ((southWall.z / 2) + 13.5)) {
-        _pEnemy2->moveBackward();
-    }
+    _pArcCam->setLookAtPoint(lookAtPoint);
+    _pArcCam->setRadius(_cameraRadius);
+    _pArcCam->recomputeOrientation();
 
-    if (currPos.x > ((westWall.x / 2) - 13.5) && currPos.x < ((westWall.x / 2) + 13.5) && currPos.z > ((westWall.z / 2) - 1.5) && currPos.z < ((westWall.z / 2) + 1.5)) {
-        _pEnemy2->moveBackward();
+    // the walls never move once the world is built, so the render thread can cast against them
+    const StaticBVH::Ray ray = {lookAtPoint, glm::normalize(_pArcCam->getPosition() - lookAtPoint), _cameraRadius};
+    StaticBVH::RayHit hit;
+    _pWorld->getWalls().getHierarchy().raycast(&ray, 1, &hit);
+    if (hit.box != StaticBVH::NO_BOX) {
+        _pArcCam->setRadius(glm::max(hit.distance - CAMERA_WALL_GAP, MIN_OCCLUDED_CAMERA_RADIUS));
+        _pArcCam->recomputeOrientation();
     }
 }
 
-void A5Engine::isCollisionBackward(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall) {
-    if (currPos.x > (northWall.x - 1.5) && currPos.x < (northWall.x + 1.5) && currPos.z > (northWall.z - 31.5) && currPos.z < (northWall.z + 31.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > (eastWall.x - 31.5) && currPos.x < (eastWall.x + 31.5) && currPos.z > (eastWall.z - 1.5) && currPos.z < (eastWall.z + 1.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > (southWall.x - 1.5) && currPos.x < (southWall.x + 1.5) && currPos.z > (southWall.z - 31.5) && currPos.z < (southWall.z + 31.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > (westWall.x - 31.5) && currPos.x < (westWall.x + 31.5) && currPos.z > (westWall.z - 1.5) && currPos.z < (westWall.z + 1.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > ((northWall.x / 2) - 1.5) && currPos.x < ((northWall.x / 2) + 1.5) && currPos.z > ((northWall.z / 2) - 13.5) && currPos.z < ((northWall.z / 2) + 13.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > ((eastWall.x / 2) - 13.5) && currPos.x < ((eastWall.x / 2) + 13.5) && currPos.z > ((eastWall.z / 2) - 1.5) && currPos.z < ((eastWall.z / 2) + 1.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > ((southWall.x / 2) - 1.5) && currPos.x < ((southWall.x / 2) + 1.5) && currPos.z > ((southWall.z / 2) - 13.5) && currPos.z < ((southWall.z / 2) + 13.5)) {
-        _pHero->moveForward();
-    }
-
-    if (currPos.x > ((westWall.x / 2) - 13.5) && currPos.x < ((westWall.x / 2) + 13.5) && currPos.z > ((westWall.z / 2) - 1.5) && currPos.z < ((westWall.z / 2) + 1.5)) {
-        _pHero->moveForward();
+void A5Engine::_pollEvents() {
+    {
+        A5_PROFILE_SCOPE("render.pollEvents");
+        glfwPollEvents();				            // check for any events and signal to redraw screen
     }
+    // events that arrive from now on wait in the queue until the next poll
+    _lastPollTime = glfwGetTime();
 }
 
-void A5Engine::isCollisionEnemies(glm::vec3 currPosEnemy1, glm::vec3 currPosEnemy2) {
-    if ((currPosEnemy1.x + 1 > currPosEnemy2.x - 1) && (currPosEnemy1.x - 1 < currPosEnemy2.x + 1) && (currPosEnemy1.z + 1 > currPosEnemy2.z - 1) && (currPosEnemy1.z - 1 < currPosEnemy2.z + 1)) {
-        _pEnemy1->setEnemyColor(glm::vec3(0,0,1));
-        enemy2Dead = true;
-        _pEnemy1->setEnemySize();
-//        _pEnemy2->setEnemyColor(glm::vec3(0,0,1));
+void A5Engine::_recordInputLatency(const WorldSnapshot& snapshot) {
+    // the swap has returned, which is as close to the frame being presented as the CPU can see
+    const GLdouble presentTime = glfwGetTime();
+    if (_drawnCameraInputTime != NO_PENDING_INPUT) {
+        Profiler::instance().addSample(_cameraLatencyZone, (presentTime - _drawnCameraInputTime) * 1000.0);
+        _drawnCameraInputTime = NO_PENDING_INPUT;
     }
-}
-
-void A5Engine::isCollisionEnemyHero(glm::vec3 currPosEnemy1, glm::vec3 currPosEnemy2, glm::vec3 currPosHero) {
-    if (((currPosEnemy1.x + 1 > currPosHero.x - 1) && (currPosEnemy1.x - 1 < currPosHero.x + 1) && (currPosEnemy1.z + 1 > currPosHero.z - 1) && (currPosEnemy1.z - 1 < currPosHero.z + 1)) || ((currPosEnemy2.x + 1 > currPosHero.x - 1) && (currPosEnemy2.x - 1 < currPosHero.x + 1) && (currPosEnemy2.z + 1 > currPosHero.z - 1) && (currPosEnemy2.z - 1 < currPosHero.z + 1))) {
-        isLoser();
+    // sequence numbers only grow, so any later change has been stepped as well
+    if (_moveInputHandedOver && snapshot.inputSequence >= _moveInputSequence) {
+        Profiler::instance().addSample(_moveLatencyZone, (presentTime - _moveInputTime) * 1000.0);
+        _moveInputTime = NO_PENDING_INPUT;
+        _moveInputHandedOver = false;
     }
 }
 
-void A5Engine::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    // precompute the Model-View-Projection matrix on the CPU
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
-    // then send it to the shader on the GPU to apply to every vertex
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.mvpMatrix, mvpMtx);
-
-    // TODO #7: compute and send the normal matrix
-    glm::mat3 normalMtx = glm::mat3(glm::transpose(glm::inverse(modelMtx)));
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.normalMatrix, normalMtx);
-
+void A5Engine::_uploadFrameData(glm::mat4 viewMtx, glm::mat4 projMtx) const {
+    // the view-projection product is computed once here instead of once per object
+    FrameData frameData = {
+            viewMtx,
+            projMtx,
+            projMtx * viewMtx,
+            glm::vec4(_lightDirection, 0.0f),
+            glm::vec4(_lightColor, 0.0f)
+    };
+    glBindBuffer(GL_UNIFORM_BUFFER, _frameDataUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &frameData);
 }
 
 //*************************************************************************************
@@ -711,4 +612,28 @@ void lab05_engine_mouse_button_callback(GLFWwindow *window, int button, int acti
 
     // pass the mouse button and action through to the engine
     engine->handleMouseButtonEvent(button, action);
-}
\ No newline at end of file
+}
+
+void A5Engine::_printStressReport() const {
+    if (_stressFrameTimes.empty()) return;
+
+    std::vector<GLdouble> sorted = _stressFrameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    GLdouble total = 0.0;
+    for (GLdouble frameTime : sorted) total += frameTime;
+    // nearest rank, matching the profiler's percentiles
+    auto percentile = [&sorted](GLdouble p) {
+        return sorted[std::min((size_t)((GLdouble)sorted.size() * p), sorted.size() - 1)];
+    };
+
+    const auto numFrames = (GLdouble)sorted.size();
+    fprintf(stdout, "[INFO]: Stress run - %zu frames, %.1f fps\n", sorted.size(), numFrames * 1000.0 / total);
+    fprintf(stdout, "[INFO]: frame ms  avg %.3f  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+            total / numFrames, percentile(0.5), percentile(0.9), percentile(0.99), sorted.back());
+
+    // zones on the simulation thread overlap the frame, so their costs do not add up to it
+    fprintf(stdout, "[INFO]: %-24s %12s %10s %10s\n", "zone", "ms/frame", "calls", "dropped");
+    for (const Profiler::ZoneStats& stats : Profiler::instance().getStats()) {
+        fprintf(stdout, "[INFO]: %-24s %12.4f %10u %10u\n", stats.name, stats.totalMs / numFrames, stats.totalCalls, stats.numDropped);
+    }
+}
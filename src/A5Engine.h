@@ -6,19 +6,61 @@
 #include <CSCI441/OpenGLEngine.hpp>
 #include <CSCI441/ShaderProgram.hpp>
 
-#include "Hero.h"
-#include "Enemy.h"
-#include "Walls.h"
-
+#include "FramePacer.h"
+#include "GameWorld.h"
+#include "GpuTimer.h"
+#include "InputRecording.h"
+#include "SimulationThread.h"
+#include "WorldSnapshot.h"
+#include "HeroRenderer.h"
+#include "WallRenderer.h"
+#include "TileRenderer.h"
+#include "HordeRenderer.h"
+#include "FrustumCuller.h"
+#include "LevelOfDetail.h"
+#include "RenderQueue.h"
+
+#include <string>
 #include <vector>
 
 class A5Engine final : public CSCI441::OpenGLEngine {
 public:
-    A5Engine();
+    /// \param worldConfig enemies, tile grid, walls and seed of the world to play in
+    explicit A5Engine(const GameWorld::Config& worldConfig = GameWorld::Config());
     ~A5Engine() final;
 
     void run() final;
 
+    /// \desc changes how many times per second the simulation is stepped, gameplay speed is unaffected
+    /// \param ticksPerSecond number of simulation ticks per second
+    /// \note only takes effect if called before run
+    void setTickRate(GLdouble ticksPerSecond) { _pSimulation->setTickRate(ticksPerSecond); }
+
+    /// \desc records the controls of every tick and saves them when the game ends, so the session
+    /// can be replayed through A5Sim
+    /// \param filename file to write the recording to
+    /// \note only takes effect if called before run
+    void setRecordingFile(const char* filename);
+
+    /// \desc runs for a fixed number of frames with vsync off, whatever happens in the game, then
+    /// reports frame time percentiles and how much of each frame every profiled zone cost
+    /// \param numFrames frames to draw before closing, 0 plays normally
+    /// \note only takes effect if called before initialize
+    void setStressFrames(GLuint numFrames) { _stressFrames = numFrames; }
+
+    /// \desc chooses how buffer swaps wait for the display, on unless changed
+    /// \note only takes effect if called before initialize, adaptive falls back to on where the
+    /// driver does not support it
+    void setVsyncMode(FramePacer::VsyncMode mode) { _vsyncMode = mode; }
+
+    /// \desc caps the frame rate, so the game does not spin a core drawing frames nobody sees
+    /// \param framesPerSecond target rate, 0 leaves frames uncapped
+    void setTargetFps(GLdouble framesPerSecond) { _framePacer.setTargetFps(framesPerSecond); }
+
+    /// \desc polls events at the start of every frame instead of after the swap, so input reaches
+    /// the screen a frame sooner
+    void setLowLatencyLoop(bool enabled) { _lowLatencyLoop = enabled; }
+
     /// \desc handle any key events inside the engine
     /// \param key key as represented by GLFW_KEY_ macros
     /// \param action key event action as represented by GLFW_ macros
@@ -36,14 +78,6 @@ public:
     /// \desc value off-screen to represent mouse has not begun interacting with window yet
     static constexpr GLfloat MOUSE_UNINITIALIZED = -9999.0f;
 
-    // Initialize variables for enemy tracking and dying.
-    glm::vec3 enemy1DirectionToHero;
-    glm::vec3 enemy2DirectionToHero;
-
-    GLuint countTiles;
-    bool enemy1Dead;
-    bool enemy2Dead;
-
 private:
     void mSetupGLFW() final;
     void mSetupOpenGL() final;
@@ -55,11 +89,21 @@ private:
     void mCleanupShaders() final;
 
     /// \desc draws everything to the scene from a particular point of view
+    /// \param snapshot state of the world published by the simulation thread
     /// \param viewMtx the current view matrix for our camera
     /// \param projMtx the current projection matrix for our camera
-    void _renderScene(glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    /// \desc handles moving our FreeCam as determined by keyboard input
-    void _updateScene();
+    /// \param alpha how far between the previous and current simulation tick to draw moving objects
+    void _renderScene(const WorldSnapshot& snapshot, glm::mat4 viewMtx, glm::mat4 projMtx, GLfloat alpha);
+    /// \desc hands the held controls to the simulation thread and moves the camera
+    /// \param frameTime seconds the last frame took
+    void _updateInput(GLdouble frameTime);
+    /// \desc prints the frame time percentiles and per zone cost of a stress run
+    void _printStressReport() const;
+    /// \desc handles any pending window events and notes when they were handled
+    void _pollEvents();
+    /// \desc adds a latency sample for every input that the frame just presented shows
+    /// \param snapshot snapshot the frame was drawn from
+    void _recordInputLatency(const WorldSnapshot& snapshot);
 
     /// \desc tracks the number of different keys that can be present as determined by GLFW
     static constexpr GLuint NUM_KEYS = GLFW_KEY_LAST;
@@ -76,28 +120,54 @@ private:
 //    CSCI441::ArcballCam* _pArcballCam;
 
     CSCI441::ArcballCam* _pArcCam;
+    /// \desc how far the camera orbits from the hero when no wall is in the way, set by zooming
+    GLfloat _cameraRadius;
+    /// \desc closest and furthest the camera can be zoomed
+    static constexpr GLfloat MIN_CAMERA_RADIUS = 5.0f;
+    static constexpr GLfloat MAX_CAMERA_RADIUS = 15.0f;
+    /// \desc closest a wall can push the camera to the hero
+    static constexpr GLfloat MIN_OCCLUDED_CAMERA_RADIUS = 0.5f;
+    /// \desc space kept between the camera and a wall it is pulled in front of
+    static constexpr GLfloat CAMERA_WALL_GAP = 0.25f;
     /// \desc pair of values to store the speed the camera can move/rotate.
     /// \brief x = forward/backward delta, y = rotational delta
     glm::vec2 _cameraSpeed;
 
-    /// \desc our current hero's position
-    glm::vec3 _currHeroPos;
     GLfloat _currHeroHeight;
 
-    /// \desc our hero model
-    Hero* _pHero;
-
-    /// \desc our first enemy model
-    Enemy* _pEnemy1;
+    /// \desc game state and rules, free of any GL or window state
+    /// \note only the simulation thread touches it while the game runs, except for the
+    /// walls which never change after construction
+    GameWorld* _pWorld;
+    /// \desc steps the world on its own thread and publishes snapshots of it to draw
+    SimulationThread* _pSimulation;
+    /// \desc controls of every tick, nullptr when the session is not being recorded
+    InputRecording* _pRecording;
+    /// \desc file the recording is saved to once the game ends
+    std::string _recordingFilename;
+    /// \desc frames left to draw in a stress run, 0 when playing normally
+    GLuint _stressFrames;
+    /// \desc milliseconds every frame of the stress run took
+    std::vector<GLdouble> _stressFrameTimes;
+    /// \desc tick of the snapshot whose tile changes were last handed to the tile renderer
+    GLuint _drawnTickCount;
+
+    /// \desc draws our hero model
+    HeroRenderer* _pHeroRenderer;
+
+    /// \desc draws every live enemy with a single instanced draw call
+    HordeRenderer* _pHordeRenderer;
+
+    /// \desc draws our walls model
+    WallRenderer* _pWallRenderer;
+
+    /// \desc rejects anything outside the camera's view before it is submitted
+    FrustumCuller _culler;
+    /// \desc picks how finely characters are tessellated from their size on screen
+    LevelOfDetail _lod;
+    /// \desc every draw of the frame is submitted here and sorted by state before it reaches the GPU
+    RenderQueue _renderQueue;
 
-    /// \desc our second enemy model
-    Enemy* _pEnemy2;
-
-    /// \desc our walls model
-    Walls* _pWalls;
-
-    /// \desc the size of the world (controls the ground size and locations of tiles)
-    static constexpr GLfloat WORLD_SIZE = 55.0f;
     /// \desc VAO for our ground
     GLuint _groundVAO;
     /// \desc the number of points that make up our ground object
@@ -106,67 +176,124 @@ private:
     /// \desc creates the ground VAO
     void _createGroundBuffers();
 
-    /// \desc smart container to store information specific to each tile we wish to draw
-    struct TileData {
-        /// \desc transformations to position and size the tiles
-        glm::mat4 modelMatrix;
-        /// \desc color to draw the tiles
-        glm::vec3 color;
-
-        glm::vec3 _tileLocations;
-    };
-    /// \desc information list of all the tiles to draw
-    std::vector<TileData> _tiles;
+    /// \desc draws all of the tiles with a single instanced draw call
+    TileRenderer* _pTileRenderer;
 
-    /// \desc generates tiles information to make up our scene
+    /// \desc hands the world's tiles to the tile renderer
     void _generateEnvironment();
 
     /// \desc shader program that performs lighting
     CSCI441::ShaderProgram* _lightingShaderProgram = nullptr;   // the wrapper for our shader program
     /// \desc stores the locations of all of our shader uniforms
     struct LightingShaderUniformLocations {
-        /// \desc precomputed MVP matrix location
-        GLint mvpMatrix;
+        /// \desc model matrix location
+        GLint modelMatrix;
         /// \desc material diffuse color location
         GLint materialColor;
-        // TODO #1: add new uniforms
-        GLint normalMatrix;
-        GLint lightDirection;
-        GLint lightColor;
-
-
     } _lightingShaderUniformLocations;
     /// \desc stores the locations of all of our shader attributes
     struct LightingShaderAttributeLocations {
         /// \desc vertex position location
         GLint vPos;
-        // TODO #2: add new attributes
         GLint vertexNormal;
-
+        /// \desc per-vertex color location, multiplied with the material color
+        GLint vertexColor;
     } _lightingShaderAttributeLocations;
 
-    void _updateCamPosition();
-
-    /// \desc precomputes the matrix uniforms CPU-side and then sends them
-    /// to the GPU to be used in the shader for each vertex.  It is more efficient
-    /// to calculate these once and then use the resultant product in the shader.
-    /// \param modelMtx model transformation matrix
+    /// \desc shader program that performs lighting for instanced geometry
+    CSCI441::ShaderProgram* _instancedShaderProgram = nullptr;
+    /// \desc stores the locations of all of our instanced shader attributes
+    struct InstancedShaderAttributeLocations {
+        /// \desc vertex position location
+        GLint vPos;
+        GLint vertexNormal;
+        /// \desc first location of the per-instance model matrix
+        GLint instanceModelMatrix;
+        /// \desc first location of the per-instance normal matrix
+        GLint instanceNormalMatrix;
+        /// \desc per-instance material color location
+        GLint instanceColor;
+    } _instancedShaderAttributeLocations;
+
+    /// \desc shader program that performs lighting for the enemy horde
+    CSCI441::ShaderProgram* _hordeShaderProgram = nullptr;
+    /// \desc stores the locations of all of our horde shader attributes
+    struct HordeShaderAttributeLocations {
+        /// \desc vertex position location
+        GLint vPos;
+        GLint vertexNormal;
+        GLint vertexColor;
+        /// \desc per-instance world position and heading location
+        GLint instancePositionHeading;
+        /// \desc per-instance body scale location
+        GLint instanceScale;
+        /// \desc per-instance head color location
+        GLint instanceColor;
+    } _hordeShaderAttributeLocations;
+
+    /// \desc binding point the per-frame uniform block is attached to in every shader
+    static constexpr GLuint FRAME_DATA_BINDING = 0;
+    /// \desc CPU side mirror of the FrameData uniform block, laid out to match std140
+    struct FrameData {
+        glm::mat4 viewMatrix;
+        glm::mat4 projectionMatrix;
+        glm::mat4 viewProjMatrix;
+        /// \desc xyz is the direction the light travels, w is padding
+        glm::vec4 lightDirection;
+        /// \desc rgb is the color of the light, a is padding
+        glm::vec4 lightColor;
+    };
+    /// \desc uniform buffer holding the per-frame camera and lighting data
+    GLuint _frameDataUBO;
+    /// \desc direction the light travels through the scene
+    glm::vec3 _lightDirection;
+    /// \desc color of the light
+    glm::vec3 _lightColor;
+
+    /// \desc how buffer swaps wait for the display
+    FramePacer::VsyncMode _vsyncMode;
+    /// \desc holds frames to the target rate and measures how evenly they are delivered
+    FramePacer _framePacer;
+
+    /// \desc polls events before drawing each frame rather than after presenting it
+    bool _lowLatencyLoop;
+
+    /// \desc marks an input timestamp that has nothing waiting on it
+    static constexpr GLdouble NO_PENDING_INPUT = -1.0;
+    /// \desc glfwGetTime when the last poll returned, an event handled by the next poll could
+    /// have arrived any time after it, so latencies are measured from here
+    GLdouble _lastPollTime;
+    /// \desc when the oldest camera input not yet drawn could have arrived
+    GLdouble _cameraInputTime;
+    /// \desc when the oldest camera input in the frame being drawn could have arrived
+    GLdouble _drawnCameraInputTime;
+    /// \desc when the oldest movement input not yet on screen could have arrived
+    GLdouble _moveInputTime;
+    /// \desc input sequence number the movement input was handed to the simulation with
+    GLuint _moveInputSequence;
+    /// \desc the movement input has been handed to the simulation and _moveInputSequence is valid
+    bool _moveInputHandedOver;
+    /// \desc profiler zones the input to present latencies are reported under
+    GLuint _cameraLatencyZone;
+    GLuint _moveLatencyZone;
+
+    /// \desc times how long the GPU spends drawing the scene
+    GpuTimer* _pSceneGpuTimer;
+    /// \desc file the profiler's zone timings are written to when the game ends
+    static constexpr const char* PROFILE_FILENAME = "profile.csv";
+    /// \desc file the recent zone timeline is written to on T and when the game ends, when run with --trace
+    static constexpr const char* TRACE_FILENAME = "trace.json";
+
+    /// \desc uploads the camera and light data for this frame into the per-frame uniform buffer
     /// \param viewMtx camera view matrix
     /// \param projMtx camera projection matrix
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-
-    // Functions for how the game works and if you won or lost.
-    void isOnTile(glm::vec3 currPos);
-    void isWinner();
-    void isLoser();
-
-    // Functions for collision checking.
-    void isCollisionForward(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall);
-    void isCollisionForwardEnemy1(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall);
-    void isCollisionForwardEnemy2(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall);
-    void isCollisionBackward(glm::vec3 currPos, glm::vec3 northWall, glm::vec3 eastWall, glm::vec3 southWall, glm::vec3 westWall);
-    void isCollisionEnemies(glm::vec3 currPosEnemy1, glm::vec3 currPosEnemy2);
-    void isCollisionEnemyHero(glm::vec3 currPosEnemy1, glm::vec3 currPosEnemy2, glm::vec3 currPosHero);
+    void _uploadFrameData(glm::mat4 viewMtx, glm::mat4 projMtx) const;
+
+    /// \desc points the camera at the hero as drawn this frame, pulling it in front of any wall
+    /// that would hide the hero
+    /// \param hero hero from the snapshot being drawn
+    /// \param alpha how far between the previous and current simulation tick the hero is drawn
+    void _updateCamPosition(const Hero& hero, GLfloat alpha);
 };
 
 void lab05_engine_keyboard_callback(GLFWwindow *window, int key, int scancode, int action, int mods );
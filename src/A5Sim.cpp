@@ -0,0 +1,400 @@
+/*
+ *  File: A5Sim.cpp
+ *
+ *  Description:
+ *      Steps the game world at full CPU speed with no window or GL context.  A simple bot
+ *      drives the hero towards the nearest unvisited tile, preferring tiles no wall hides, so
+ *      runs exercise every rule.
+ *      Used for soak tests and benchmarks on machines without a display.
+ *
+ *      Sessions recorded by A5 or by the bot can be replayed tick for tick, as fast as the
+ *      CPU allows, to compare performance across builds against an identical run.  A replay
+ *      that does not end in the recorded state exits with an error.
+ *
+ *      --verify checks every query of the wall hierarchy against testing each box in turn, over
+ *      random levels, and exits with an error if any answer differs.
+ *
+ *  Usage:
+ *      A5Sim [--ticks N] [--enemies N] [--tiles CxR] [--walls N] [--tick-rate HZ] [--seed N]
+ *            [--record FILE] [--trace FILE]
+ *      A5Sim --replay FILE [--trace FILE]
+ *      A5Sim --verify [--seed N]
+ *
+ */
+
+#include "ColliderSet.h"
+#include "GameWorld.h"
+#include "FixedTimestep.h"
+#include "InputRecording.h"
+#include "Profiler.h"
+#include "StaticBVH.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+
+/// \desc settings read from the command line
+struct SimOptions {
+    /// \desc number of ticks to step before stopping, the run also ends when the game does
+    GLuint numTicks;
+    /// \desc enemies, tile grid, walls and seed of the world the bot plays in
+    GameWorld::Config world;
+    /// \desc simulation ticks per second of game time
+    GLdouble tickRate;
+    /// \desc file to save the bot's controls to, nullptr to not record
+    const char* recordFilename;
+    /// \desc recording to replay instead of running the bot, nullptr to run the bot
+    const char* replayFilename;
+    /// \desc file to save the zone timeline to once the run ends, nullptr to not save it
+    const char* traceFilename;
+    /// \desc check the wall hierarchy against brute force instead of running the bot
+    bool verify;
+};
+
+/// \desc wraps an angle into [-pi, pi]
+static GLfloat wrapAngle( GLfloat angle ) {
+    const GLfloat TWO_PI = glm::two_pi<float>();
+    angle = std::fmod(angle + glm::pi<float>(), TWO_PI);
+    if( angle < 0.0f ) angle += TWO_PI;
+    return angle - glm::pi<float>();
+}
+
+/// \desc lists botInput fills in every tick, kept from one tick to the next so a tick allocates nothing
+struct BotScratch {
+    /// \param numTiles tiles in the world, the most that can be unvisited at once
+    explicit BotScratch( size_t numTiles ) : visible(new bool[numTiles]) {
+        unvisited.reserve(numTiles);
+        eyes.reserve(numTiles);
+        targets.reserve(numTiles);
+    }
+
+    /// \desc index of each unvisited tile
+    std::vector<GLuint> unvisited;
+    /// \desc the sight line to each unvisited tile, from the hero to the tile
+    std::vector<glm::vec3> eyes;
+    std::vector<glm::vec3> targets;
+    /// \desc whether each sight line is clear of walls
+    std::unique_ptr<bool[]> visible;
+};
+
+/// \desc picks the controls for one tick: face the nearest unvisited tile, preferring one no wall
+/// hides, and walk to it
+static GameWorld::Input botInput( const GameWorld& world, BotScratch& scratch ) {
+    GameWorld::Input input = {false, false, false, false};
+
+    const glm::vec3 heroPos = world.getHero().getCurrPos();
+    const std::vector<GameWorld::Tile>& tiles = world.getTiles();
+
+    // sight lines run along the floor, the hero is drawn taller than the walls
+    const glm::vec3 eye(heroPos.x, 0.0f, heroPos.z);
+    std::vector<GLuint>& unvisited = scratch.unvisited;
+    unvisited.clear();
+    scratch.eyes.clear();
+    scratch.targets.clear();
+    for( GLuint i = 0; i < tiles.size(); i++ ) {
+        if( world.isTileVisited(i) ) continue;
+        unvisited.push_back(i);
+        scratch.eyes.push_back(eye);
+        scratch.targets.emplace_back(tiles[i].location.x, 0.0f, tiles[i].location.z);
+    }
+    const bool* visible = scratch.visible.get();
+    world.getWalls().getHierarchy().testLineOfSight(scratch.eyes.data(), scratch.targets.data(), (GLuint)unvisited.size(), scratch.visible.get());
+
+    const GameWorld::Tile* pTarget = nullptr;
+    bool targetVisible = false;
+    GLfloat targetDistance = 0.0f;
+    for( GLuint u = 0; u < unvisited.size(); u++ ) {
+        const GameWorld::Tile& tile = tiles[unvisited[u]];
+        glm::vec3 offset = tile.location - heroPos;
+        GLfloat distance = offset.x * offset.x + offset.z * offset.z;
+        if( pTarget == nullptr || (visible[u] && !targetVisible)
+            || (visible[u] == targetVisible && distance < targetDistance) ) {
+            pTarget = &tile;
+            targetVisible = visible[u];
+            targetDistance = distance;
+        }
+    }
+    if( pTarget == nullptr ) return input;
+
+    // headings follow the same convention as the hero, +x is zero and angles grow towards -z
+    glm::vec3 offset = pTarget->location - heroPos;
+    GLfloat targetHeading = std::atan2(-offset.z, offset.x);
+    GLfloat headingError = wrapAngle(targetHeading - world.getHero().getBodyAngle());
+
+    const GLfloat TURN_TOLERANCE = glm::pi<float>() / 32.0f;
+    if( headingError > TURN_TOLERANCE ) {
+        input.turnLeft = true;
+    } else if( headingError < -TURN_TOLERANCE ) {
+        input.turnRight = true;
+    }
+    // only walk once roughly facing the tile so the bot does not circle it
+    input.moveForward = std::fabs(headingError) < glm::quarter_pi<float>();
+    return input;
+}
+
+/// \desc reads the command line, anything unrecognized prints the usage and exits
+static SimOptions parseOptions( int argc, char* argv[] ) {
+    SimOptions options = {36000, GameWorld::Config(), FixedTimestep::REFERENCE_TICK_RATE, nullptr, nullptr, nullptr, false};
+    for( int i = 1; i < argc; i++ ) {
+        if( i + 1 < argc && strcmp(argv[i], "--ticks") == 0 ) {
+            options.numTicks = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if( i + 1 < argc && strcmp(argv[i], "--enemies") == 0 ) {
+            options.world.numEnemies = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if( i + 1 < argc && strcmp(argv[i], "--tiles") == 0
+                   && sscanf(argv[i + 1], "%ux%u", &options.world.tileColumns, &options.world.tileRows) == 2 ) {
+            i++;
+        } else if( i + 1 < argc && strcmp(argv[i], "--walls") == 0 ) {
+            options.world.numWalls = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if( i + 1 < argc && strcmp(argv[i], "--tick-rate") == 0 ) {
+            options.tickRate = strtod(argv[++i], nullptr);
+        } else if( i + 1 < argc && strcmp(argv[i], "--seed") == 0 ) {
+            options.world.seed = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if( i + 1 < argc && strcmp(argv[i], "--record") == 0 ) {
+            options.recordFilename = argv[++i];
+        } else if( i + 1 < argc && strcmp(argv[i], "--replay") == 0 ) {
+            options.replayFilename = argv[++i];
+        } else if( i + 1 < argc && strcmp(argv[i], "--trace") == 0 ) {
+            options.traceFilename = argv[++i];
+        } else if( strcmp(argv[i], "--verify") == 0 ) {
+            options.verify = true;
+        } else {
+            fprintf( stderr, "Usage: %s [--ticks N] [--enemies N] [--tiles CxR] [--walls N] [--tick-rate HZ] [--seed N] [--record FILE] [--trace FILE]\n", argv[0] );
+            fprintf( stderr, "       %s --replay FILE [--trace FILE]\n", argv[0] );
+            fprintf( stderr, "       %s --verify [--seed N]\n", argv[0] );
+            exit(EXIT_FAILURE);
+        }
+    }
+    if( options.tickRate <= 0.0 ) {
+        fprintf( stderr, "[ERROR]: tick rate must be positive\n" );
+        exit(EXIT_FAILURE);
+    }
+    if( options.world.tileColumns == 0 || options.world.tileRows == 0 ) {
+        fprintf( stderr, "[ERROR]: tile grid needs at least one column and one row\n" );
+        exit(EXIT_FAILURE);
+    }
+    return options;
+}
+
+/// \desc prints how a run went, the hero's final position tells two replays of a session apart
+/// \param stepSeconds time spent inside GameWorld::step, the ticks/second are measured from it alone
+/// \param botSeconds time the bot spent choosing its input, 0 when replaying
+static void printReport( const GameWorld& world, GLfloat dt, GLdouble stepSeconds, GLdouble botSeconds ) {
+    const glm::vec3 heroPos = world.getHero().getCurrPos();
+    const GameWorld::Config& config = world.getConfig();
+    fprintf( stdout, "[INFO]: seed:          %u\n", config.seed );
+    fprintf( stdout, "[INFO]: world:         %u enemies, %ux%u tiles, %u walls\n",
+             config.numEnemies, config.tileColumns, config.tileRows, config.numWalls );
+    fprintf( stdout, "[INFO]: ticks:         %u\n", world.getTickCount() );
+    fprintf( stdout, "[INFO]: game time:     %.2f s\n", world.getTickCount() * dt );
+    fprintf( stdout, "[INFO]: step time:     %.4f s\n", stepSeconds );
+    if( botSeconds > 0.0 ) {
+        fprintf( stdout, "[INFO]: bot time:      %.4f s\n", botSeconds );
+    }
+    fprintf( stdout, "[INFO]: ticks/second:  %.0f\n", stepSeconds > 0.0 ? world.getTickCount() / stepSeconds : 0.0 );
+    fprintf( stdout, "[INFO]: tiles visited: %u / %zu\n", world.getVisitedTileCount(), world.getTiles().size() );
+    fprintf( stdout, "[INFO]: hero position: (%.6f, %.6f, %.6f)\n", heroPos.x, heroPos.y, heroPos.z );
+    fprintf( stdout, "[INFO]: result:        %s\n", world.hasWon() ? "won" : (world.isFinished() ? "lost" : "unfinished") );
+    Profiler::instance().printStats(stdout);
+}
+
+/// \desc steps a recorded session through a fresh world built the same way as the original
+static int runReplay( const char* filename ) {
+    InputRecording recording;
+    if( !recording.load(filename) ) {
+        return EXIT_FAILURE;
+    }
+    const auto dt = (GLfloat)(1.0 / recording.getTickRate());
+
+    GameWorld world(recording.getWorldConfig());
+
+    auto startTime = std::chrono::steady_clock::now();
+    for( GLuint tick = 0; tick < recording.getNumTicks(); tick++ ) {
+        world.step(recording.getInput(tick), dt);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    printReport(world, dt, std::chrono::duration<GLdouble>(endTime - startTime).count(), 0.0);
+    if( !recording.hasFinalState() ) {
+        fprintf( stdout, "[INFO]: replay:        no final state recorded, not checked\n" );
+    } else if( !recording.matchesFinalState(world) ) {
+        fprintf( stderr, "[ERROR]: replay ended in a different state than the recorded session\n" );
+        return EXIT_FAILURE;
+    } else {
+        fprintf( stdout, "[INFO]: replay:        matches the recorded session\n" );
+    }
+    return EXIT_SUCCESS;
+}
+
+/// \desc nearest distance along a ray to a box, found by slab test against the box alone
+/// \returns false if the ray misses the box before its max distance
+static bool castRayAtBox( const AABB& box, const StaticBVH::Ray& ray, GLfloat& distance ) {
+    GLfloat enter = -std::numeric_limits<GLfloat>::max();
+    GLfloat exit = std::numeric_limits<GLfloat>::max();
+    for( GLuint a = 0; a < 3; a++ ) {
+        if( ray.direction[a] == 0.0f ) {
+            // parallel to the slab, inside it the whole way or never
+            if( ray.origin[a] < box.minCorner[a] || ray.origin[a] > box.maxCorner[a] ) return false;
+            continue;
+        }
+        const GLfloat toMin = (box.minCorner[a] - ray.origin[a]) / ray.direction[a];
+        const GLfloat toMax = (box.maxCorner[a] - ray.origin[a]) / ray.direction[a];
+        enter = std::max(enter, std::min(toMin, toMax));
+        exit = std::min(exit, std::max(toMin, toMax));
+    }
+    if( enter > exit || exit < 0.0f || enter > ray.maxDistance ) return false;
+    distance = std::max(enter, 0.0f);
+    return true;
+}
+
+/// \desc checks every query of StaticBVH against testing each box in turn, over random levels of
+/// random boxes and random points, regions, rays and moves
+/// \returns number of queries whose answers differed
+static GLuint verifyHierarchy( GLuint seed ) {
+    const GLuint NUM_LEVELS = 40;
+    const GLuint QUERIES_PER_LEVEL = 2000;
+    const GLfloat RAY_LENGTH = 50.0f;
+    // a little past the standard world so queries also land beyond every box
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<GLfloat> coordinate(-60.0f, 60.0f);
+    std::uniform_real_distribution<GLfloat> size(0.5f, 12.0f);
+    std::uniform_real_distribution<GLfloat> unit(-1.0f, 1.0f);
+
+    GLuint numQueries = 0;
+    GLuint numMismatches = 0;
+    std::vector<GLuint> found, firstFound, expected;
+    for( GLuint level = 0; level < NUM_LEVELS; level++ ) {
+        // some levels are empty and some end part way through a group, some boxes sit on whole
+        // coordinates so queries land exactly on their faces
+        const GLuint numBoxes = level * 13 % 517;
+        std::vector<AABB> boxes;
+        for( GLuint i = 0; i < numBoxes; i++ ) {
+            glm::vec3 center(coordinate(random), 0.0f, coordinate(random));
+            if( i % 7 == 0 ) center = glm::vec3(std::round(center.x), 0.0f, std::round(center.z));
+            boxes.push_back(AABB::fromCenterSize(center, glm::vec3(size(random), 5.0f, size(random))));
+        }
+        StaticBVH hierarchy;
+        hierarchy.build(boxes);
+        ColliderSet colliders;
+        for( const AABB& box : boxes ) colliders.add(box);
+
+        for( GLuint q = 0; q < QUERIES_PER_LEVEL; q++ ) {
+            glm::vec3 point(coordinate(random), unit(random) * 4.0f, coordinate(random));
+            if( q % 5 == 0 ) point = glm::vec3(std::round(point.x), point.y, std::round(point.z));
+
+            GLuint count;
+            hierarchy.countContainingXZ(&point, 1, &count);
+            GLuint expectedCount = 0;
+            for( const AABB& box : boxes ) expectedCount += box.containsXZ(point) ? 1 : 0;
+            if( count != expectedCount ) numMismatches++;
+
+            const AABB region = AABB::fromCenterSize(point, glm::vec3(size(random), 1.0f, size(random)));
+            hierarchy.findOverlappingXZ(&region, 1, found, firstFound);
+            expected.clear();
+            for( GLuint i = 0; i < boxes.size(); i++ ) {
+                if( boxes[i].overlapsXZ(region) ) expected.push_back(i);
+            }
+            std::sort(found.begin(), found.end());
+            if( found != expected ) numMismatches++;
+
+            glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random) * 0.3f, unit(random)));
+            if( q % 3 == 0 ) direction = glm::vec3(1.0f, 0.0f, 0.0f);
+            const StaticBVH::Ray ray = {point, direction, RAY_LENGTH};
+            StaticBVH::RayHit hit;
+            hierarchy.raycast(&ray, 1, &hit);
+            GLint nearestBox = StaticBVH::NO_BOX;
+            GLfloat nearestDistance = 0.0f;
+            for( GLuint i = 0; i < boxes.size(); i++ ) {
+                GLfloat distance;
+                if( castRayAtBox(boxes[i], ray, distance) && (nearestBox == StaticBVH::NO_BOX || distance < nearestDistance) ) {
+                    nearestBox = (GLint)i;
+                    nearestDistance = distance;
+                }
+            }
+            // boxes can tie for nearest, so only the distance has to agree
+            if( (hit.box == StaticBVH::NO_BOX) != (nearestBox == StaticBVH::NO_BOX)
+                || (nearestBox != StaticBVH::NO_BOX && std::fabs(hit.distance - nearestDistance) > 1.0e-4f) ) {
+                numMismatches++;
+            }
+
+            const glm::vec3 lineEnd = point + direction * RAY_LENGTH;
+            bool visible;
+            hierarchy.testLineOfSight(&point, &lineEnd, 1, &visible);
+            if( visible != (nearestBox == StaticBVH::NO_BOX) ) numMismatches++;
+
+            const glm::vec3 displacement(unit(random) * 3.0f, 0.0f, unit(random) * 3.0f);
+            if( hierarchy.sweepXZ(point, displacement) != colliders.sweepXZ(point, displacement) ) numMismatches++;
+
+            numQueries += 5;
+        }
+    }
+    fprintf( stdout, "[INFO]: verify:        %u levels, %u queries, %u mismatches\n", NUM_LEVELS, numQueries, numMismatches );
+    return numMismatches;
+}
+
+/// \desc lets the bot play until it wins, loses or runs out of ticks
+static int runBot( const SimOptions& options ) {
+    const auto dt = (GLfloat)(1.0 / options.tickRate);
+
+    GameWorld world(options.world);
+
+    InputRecording recording;
+    recording.begin(world.getConfig(), options.tickRate);
+    BotScratch scratch(world.getTiles().size());
+
+    // the bot's line of sight search costs more than a step, so it is timed apart from the world
+    std::chrono::steady_clock::duration stepTime(0), botTime(0);
+    auto tickStart = std::chrono::steady_clock::now();
+    while( world.getTickCount() < options.numTicks && !world.isFinished() && !world.hasWon() ) {
+        GameWorld::Input input = botInput(world, scratch);
+        if( options.recordFilename != nullptr ) {
+            recording.record(input);
+        }
+        auto stepStart = std::chrono::steady_clock::now();
+        world.step(input, dt);
+        auto stepEnd = std::chrono::steady_clock::now();
+        botTime += stepStart - tickStart;
+        stepTime += stepEnd - stepStart;
+        tickStart = stepEnd;
+    }
+    recording.finish(world);
+
+    printReport(world, dt, std::chrono::duration<GLdouble>(stepTime).count(), std::chrono::duration<GLdouble>(botTime).count());
+
+    if( options.recordFilename != nullptr ) {
+        if( !recording.save(options.recordFilename) ) {
+            return EXIT_FAILURE;
+        }
+        fprintf( stdout, "[INFO]: Recorded %u ticks to \"%s\"\n", recording.getNumTicks(), options.recordFilename );
+    }
+    return EXIT_SUCCESS;
+}
+
+///*****************************************************************************
+//
+// Our main function
+int main( int argc, char* argv[] ) {
+    const SimOptions options = parseOptions(argc, argv);
+    TraceRecorder::instance().setThreadName("main");
+    // the timeline is only kept when it will be written out
+    TraceRecorder::instance().setEnabled(options.traceFilename != nullptr);
+
+    int result;
+    if( options.verify ) {
+        result = verifyHierarchy(options.world.seed) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+        result = options.replayFilename != nullptr ? runReplay(options.replayFilename) : runBot(options);
+    }
+
+    if( options.traceFilename != nullptr && TraceRecorder::instance().writeJson(options.traceFilename) ) {
+        fprintf( stdout, "[INFO]: Wrote trace to \"%s\"\n", options.traceFilename );
+    }
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef A5_AABB_H
+#define A5_AABB_H
+
+#include <glm/glm.hpp>
+
+/// \desc axis aligned bounding box stored as its two extreme corners
+struct AABB {
+    /// \desc corner with the smallest x, y and z
+    glm::vec3 minCorner;
+    /// \desc corner with the largest x, y and z
+    glm::vec3 maxCorner;
+
+    /// \desc creates a box from its center and full size along each axis
+    static AABB fromCenterSize(glm::vec3 center, glm::vec3 size) {
+        return { center - size * 0.5f, center + size * 0.5f };
+    }
+
+    /// \desc center point of the box
+    [[nodiscard]] glm::vec3 getCenter() const {
+        return (minCorner + maxCorner) * 0.5f;
+    }
+
+    /// \desc radius of the sphere centered on the box that encloses it
+    [[nodiscard]] float getBoundingRadius() const {
+        return glm::length(maxCorner - minCorner) * 0.5f;
+    }
+
+    /// \desc checks if a point lies strictly inside the box when looking down the y axis
+    [[nodiscard]] bool containsXZ(glm::vec3 point) const {
+        return point.x > minCorner.x && point.x < maxCorner.x && point.z > minCorner.z && point.z < maxCorner.z;
+    }
+
+    /// \desc checks if two boxes share some area when looking down the y axis, touching faces do not count
+    [[nodiscard]] bool overlapsXZ(const AABB& other) const {
+        return minCorner.x < other.maxCorner.x && maxCorner.x > other.minCorner.x
+            && minCorner.z < other.maxCorner.z && maxCorner.z > other.minCorner.z;
+    }
+};
+
+#endif //A5_AABB_H
@@ -0,0 +1,202 @@
+#include "ColliderSet.h"
+
+#include <bitset>
+#include <limits>
+
+#if A5_COLLIDER_SET_SSE2
+#include <emmintrin.h>
+#endif
+
+ColliderSet::ColliderSet() {
+    _count = 0;
+}
+
+void ColliderSet::add(const AABB& box) {
+    // the new box takes the first padding slot, or a fresh group of padding is opened for it
+    if (_count == _minX.size()) {
+        const GLfloat LARGEST = std::numeric_limits<GLfloat>::max();
+        _minX.resize(_count + LANE_WIDTH, LARGEST);
+        _maxX.resize(_count + LANE_WIDTH, -LARGEST);
+        _minZ.resize(_count + LANE_WIDTH, LARGEST);
+        _maxZ.resize(_count + LANE_WIDTH, -LARGEST);
+    }
+    _minX[_count] = box.minCorner.x;
+    _maxX[_count] = box.maxCorner.x;
+    _minZ[_count] = box.minCorner.z;
+    _maxZ[_count] = box.maxCorner.z;
+    _count++;
+}
+
+GLuint ColliderSet::countContainingXZ(glm::vec3 point) const {
+    GLuint count = 0;
+    countContainingXZ(&point, 1, &count);
+    return count;
+}
+
+void ColliderSet::countContainingXZ(const glm::vec3* pPoints, GLuint numPoints, GLuint* pCounts) const {
+    const auto paddedCount = (GLuint)_minX.size();
+#if A5_COLLIDER_SET_SSE2
+    for (GLuint p = 0; p < numPoints; p++) {
+        const __m128 x = _mm_set1_ps(pPoints[p].x);
+        const __m128 z = _mm_set1_ps(pPoints[p].z);
+        // every lane of a passing compare is all ones, which is -1 as an integer
+        __m128i hits = _mm_setzero_si128();
+        for (GLuint b = 0; b < paddedCount; b += LANE_WIDTH) {
+            __m128 inside = _mm_and_ps(_mm_cmpgt_ps(x, _mm_loadu_ps(&_minX[b])),
+                                       _mm_cmplt_ps(x, _mm_loadu_ps(&_maxX[b])));
+            inside = _mm_and_ps(inside, _mm_cmpgt_ps(z, _mm_loadu_ps(&_minZ[b])));
+            inside = _mm_and_ps(inside, _mm_cmplt_ps(z, _mm_loadu_ps(&_maxZ[b])));
+            hits = _mm_sub_epi32(hits, _mm_castps_si128(inside));
+        }
+        // add up the four lanes
+        hits = _mm_add_epi32(hits, _mm_shuffle_epi32(hits, _MM_SHUFFLE(1, 0, 3, 2)));
+        hits = _mm_add_epi32(hits, _mm_shuffle_epi32(hits, _MM_SHUFFLE(2, 3, 0, 1)));
+        pCounts[p] = (GLuint)_mm_cvtsi128_si32(hits);
+    }
+#else
+    for (GLuint p = 0; p < numPoints; p++) {
+        const glm::vec3 point = pPoints[p];
+        GLuint hits = 0;
+        for (GLuint b = 0; b < paddedCount; b++) {
+            hits += (point.x > _minX[b]) & (point.x < _maxX[b]) & (point.z > _minZ[b]) & (point.z < _maxZ[b]);
+        }
+        pCounts[p] = hits;
+    }
+#endif
+}
+
+GLuint ColliderSet::containMaskXZ(GLuint firstBox, glm::vec3 point) const {
+#if A5_COLLIDER_SET_SSE2
+    const __m128 x = _mm_set1_ps(point.x);
+    const __m128 z = _mm_set1_ps(point.z);
+    __m128 inside = _mm_and_ps(_mm_cmpgt_ps(x, _mm_loadu_ps(&_minX[firstBox])),
+                               _mm_cmplt_ps(x, _mm_loadu_ps(&_maxX[firstBox])));
+    inside = _mm_and_ps(inside, _mm_cmpgt_ps(z, _mm_loadu_ps(&_minZ[firstBox])));
+    inside = _mm_and_ps(inside, _mm_cmplt_ps(z, _mm_loadu_ps(&_maxZ[firstBox])));
+    return (GLuint)_mm_movemask_ps(inside);
+#else
+    GLuint mask = 0;
+    for (GLuint lane = 0; lane < LANE_WIDTH; lane++) {
+        const GLuint b = firstBox + lane;
+        if (point.x > _minX[b] && point.x < _maxX[b] && point.z > _minZ[b] && point.z < _maxZ[b]) {
+            mask |= 1u << lane;
+        }
+    }
+    return mask;
+#endif
+}
+
+GLuint ColliderSet::overlapMaskXZ(GLuint firstBox, glm::vec3 regionMin, glm::vec3 regionMax) const {
+#if A5_COLLIDER_SET_SSE2
+    __m128 overlaps = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&_minX[firstBox]), _mm_set1_ps(regionMax.x)),
+                                 _mm_cmpgt_ps(_mm_loadu_ps(&_maxX[firstBox]), _mm_set1_ps(regionMin.x)));
+    overlaps = _mm_and_ps(overlaps, _mm_cmplt_ps(_mm_loadu_ps(&_minZ[firstBox]), _mm_set1_ps(regionMax.z)));
+    overlaps = _mm_and_ps(overlaps, _mm_cmpgt_ps(_mm_loadu_ps(&_maxZ[firstBox]), _mm_set1_ps(regionMin.z)));
+    return (GLuint)_mm_movemask_ps(overlaps);
+#else
+    GLuint mask = 0;
+    for (GLuint lane = 0; lane < LANE_WIDTH; lane++) {
+        const GLuint b = firstBox + lane;
+        if (_minX[b] < regionMax.x && _maxX[b] > regionMin.x && _minZ[b] < regionMax.z && _maxZ[b] > regionMin.z) {
+            mask |= 1u << lane;
+        }
+    }
+    return mask;
+#endif
+}
+
+GLuint ColliderSet::_countContainingXZ(glm::vec3 point, const GLuint* pGroups, GLuint numGroups) const {
+    GLuint count = 0;
+    for (GLuint g = 0; g < numGroups; g++) {
+        count += (GLuint)std::bitset<LANE_WIDTH>(containMaskXZ(_groupStart(pGroups, g), point)).count();
+    }
+    return count;
+}
+
+bool ColliderSet::_findFirstHit(glm::vec3 start, glm::vec3 displacement, const GLuint* pGroups, GLuint numGroups,
+                                GLfloat& hitTime, GLuint& hitAxis, GLfloat& hitFace) const {
+    bool hit = false;
+    // anything entered at the very end of the segment only touches a face, which is outside
+    hitTime = 1.0f;
+
+    // boxes that miss the segment's bounds are thrown out four at a time, the padding included
+    const glm::vec3 end = start + displacement;
+    const glm::vec3 boundsMin = glm::min(start, end);
+    const glm::vec3 boundsMax = glm::max(start, end);
+    for (GLuint g = 0; g < numGroups; g++) {
+        const GLuint group = _groupStart(pGroups, g);
+        const GLuint candidates = overlapMaskXZ(group, boundsMin, boundsMax);
+        for (GLuint lane = 0; candidates != 0 && lane < LANE_WIDTH; lane++) {
+            if ((candidates & (1u << lane)) == 0) continue;
+            const GLuint b = group + lane;
+
+            // slab test, the segment is inside the box between entering both slabs and leaving either
+            GLfloat enter = -std::numeric_limits<GLfloat>::max();
+            GLfloat exit = std::numeric_limits<GLfloat>::max();
+            GLuint enterAxis = 0;
+            GLfloat enterFace = 0.0f;
+            bool misses = false;
+            const GLuint axes[2] = {0, 2};
+            const GLfloat minima[2] = {_minX[b], _minZ[b]};
+            const GLfloat maxima[2] = {_maxX[b], _maxZ[b]};
+            for (GLuint a = 0; a < 2 && !misses; a++) {
+                const GLfloat from = start[axes[a]];
+                const GLfloat delta = displacement[axes[a]];
+                if (delta == 0.0f) {
+                    // running parallel to the slab, and the boxes are open so its faces do not count
+                    misses = from <= minima[a] || from >= maxima[a];
+                    continue;
+                }
+                GLfloat slabEnter = ((delta > 0.0f ? minima[a] : maxima[a]) - from) / delta;
+                GLfloat slabExit = ((delta > 0.0f ? maxima[a] : minima[a]) - from) / delta;
+                if (slabEnter > enter) {
+                    enter = slabEnter;
+                    enterAxis = axes[a];
+                    enterFace = delta > 0.0f ? minima[a] : maxima[a];
+                }
+                exit = glm::min(exit, slabExit);
+            }
+            // starting inside a box gives a negative entry, such a box is left to be walked out of
+            if (misses || enter >= exit || enter < 0.0f || enter >= hitTime) continue;
+
+            hit = true;
+            hitTime = enter;
+            hitAxis = enterAxis;
+            hitFace = enterFace;
+        }
+    }
+    return hit;
+}
+
+glm::vec3 ColliderSet::sweepXZ(glm::vec3 start, glm::vec3 displacement) const {
+    return sweepXZ(start, displacement, nullptr, (GLuint)_minX.size() / LANE_WIDTH);
+}
+
+glm::vec3 ColliderSet::sweepXZ(glm::vec3 start, glm::vec3 displacement, const GLuint* pGroups, GLuint numGroups) const {
+    glm::vec3 position = start;
+    glm::vec3 remaining = displacement;
+    for (GLuint slide = 0; slide < MAX_SLIDES; slide++) {
+        GLfloat hitTime;
+        GLuint hitAxis;
+        GLfloat hitFace;
+        if (!_findFirstHit(position, remaining, pGroups, numGroups, hitTime, hitAxis, hitFace)) {
+            position += remaining;
+            remaining = glm::vec3(0.0f);
+            break;
+        }
+        // stop on the face, snapped so rounding cannot leave the point a hair inside, and keep
+        // only the part of the leftover movement that runs along the face
+        position += remaining * hitTime;
+        position[hitAxis] = hitFace;
+        remaining *= 1.0f - hitTime;
+        remaining[hitAxis] = 0.0f;
+    }
+    // whatever is left after the last slide is dropped, the point is wedged in a corner
+    position.y = start.y + displacement.y;
+
+    // boxes can overlap in ways a few slides do not untangle, never leave the point worse off
+    if (_countContainingXZ(position, pGroups, numGroups) > _countContainingXZ(start, pGroups, numGroups)) {
+        return start;
+    }
+    return position;
+}
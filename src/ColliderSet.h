@@ -0,0 +1,99 @@
+#ifndef A5_COLLIDER_SET_H
+#define A5_COLLIDER_SET_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "AABB.h"
+
+/// \desc SSE2 is part of every x86-64 target, anything else takes the scalar path
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define A5_COLLIDER_SET_SSE2 1
+#else
+#define A5_COLLIDER_SET_SSE2 0
+#endif
+
+/// \desc flat set of static boxes that points are tested against when looking down the y axis.
+/// The extents are stored one array per side so several boxes are tested per instruction
+class ColliderSet {
+public:
+    /// \desc number of boxes tested together, the arrays are padded to a multiple of it
+    static constexpr GLuint LANE_WIDTH = 4;
+
+    ColliderSet();
+
+    /// \desc adds a box to the set
+    void add( const AABB& box );
+
+    /// \desc number of boxes in the set, not counting the padding
+    [[nodiscard]] GLuint getCount() const { return _count; }
+
+    /// \desc counts the boxes a point lies strictly inside of, same test as AABB::containsXZ
+    [[nodiscard]] GLuint countContainingXZ( glm::vec3 point ) const;
+
+    /// \desc counts the boxes each of a batch of points lies strictly inside of
+    /// \param pPoints points to test
+    /// \param numPoints number of points
+    /// \param pCounts receives one count per point
+    void countContainingXZ( const glm::vec3* pPoints, GLuint numPoints, GLuint* pCounts ) const;
+
+    /// \desc which boxes of a group a point lies strictly inside of when looking down the y axis
+    /// \param firstBox first box of the group, a multiple of LANE_WIDTH
+    /// \returns one bit per box of the group, lowest bit for firstBox
+    [[nodiscard]] GLuint containMaskXZ( GLuint firstBox, glm::vec3 point ) const;
+
+    /// \desc which boxes of a group share some area with a region when looking down the y axis
+    /// \param firstBox first box of the group, a multiple of LANE_WIDTH
+    /// \returns one bit per box of the group, lowest bit for firstBox
+    [[nodiscard]] GLuint overlapMaskXZ( GLuint firstBox, glm::vec3 regionMin, glm::vec3 regionMax ) const;
+
+    /// \desc moves a point along a straight line until it would enter a box, then slides the rest
+    /// of the way along the face it hit.  Boxes the point starts inside of do not stop it
+    /// \note movers are swept as their center point, the same footprint the containsXZ test they
+    /// replaced gave them, so a body still overlaps a wall by up to half its width
+    /// \param start where the point starts
+    /// \param displacement how far it tries to move, y passes straight through
+    /// \returns where the point ends up, never inside more boxes than it started in
+    [[nodiscard]] glm::vec3 sweepXZ( glm::vec3 start, glm::vec3 displacement ) const;
+
+    /// \desc same as sweepXZ, but only the listed groups of boxes can stop the point
+    /// \param pGroups first box of each group to sweep against, every box that overlaps the area
+    /// between start and start + displacement must be in one of them
+    /// \param numGroups number of groups listed
+    [[nodiscard]] glm::vec3 sweepXZ( glm::vec3 start, glm::vec3 displacement, const GLuint* pGroups, GLuint numGroups ) const;
+
+private:
+    /// \desc most faces a single sweep stops at, enough to slide into a corner and stop there
+    static constexpr GLuint MAX_SLIDES = 3;
+
+    /// \desc first box of a group, taken from the list or counted off when there is no list
+    [[nodiscard]] static GLuint _groupStart( const GLuint* pGroups, GLuint group ) {
+        return pGroups != nullptr ? pGroups[group] : group * LANE_WIDTH;
+    }
+
+    /// \desc finds the first box a segment enters
+    /// \param start where the segment starts
+    /// \param displacement the segment's length and direction, only x and z are used
+    /// \param pGroups groups to test, nullptr for all of them
+    /// \param numGroups number of groups to test
+    /// \param hitTime receives the fraction of the segment travelled before the hit
+    /// \param hitAxis receives 0 if an x face was hit or 2 for a z face
+    /// \param hitFace receives the coordinate of the face along that axis
+    /// \returns false if the whole segment is clear
+    bool _findFirstHit( glm::vec3 start, glm::vec3 displacement, const GLuint* pGroups, GLuint numGroups,
+                        GLfloat& hitTime, GLuint& hitAxis, GLfloat& hitFace ) const;
+
+    /// \desc counts the boxes of some groups a point lies strictly inside of
+    [[nodiscard]] GLuint _countContainingXZ( glm::vec3 point, const GLuint* pGroups, GLuint numGroups ) const;
+
+    GLuint _count;
+    /// \desc box extents, boxes past _count are padding that no point can lie inside of
+    std::vector<GLfloat> _minX;
+    std::vector<GLfloat> _maxX;
+    std::vector<GLfloat> _minZ;
+    std::vector<GLfloat> _maxZ;
+};
+
+#endif //A5_COLLIDER_SET_H
@@ -0,0 +1,76 @@
+#include "EnemyHorde.h"
+
+#include <cmath>
+
+EnemyHorde::EnemyHorde() = default;
+
+GLuint EnemyHorde::add(glm::vec3 position, GLfloat heading) {
+    _positions.push_back(position);
+    _headings.push_back(heading);
+    _flags.push_back(0);
+    _hoverPhases.push_back(0.0f);
+    _prevPositions.push_back(position);
+    _prevHeadings.push_back(heading);
+    _scales.push_back(START_SCALE);
+    _colors.emplace_back(1.0f, 0.0f, 0.0f);
+    return getCount() - 1;
+}
+
+glm::vec3 EnemyHorde::getRenderPos(GLuint i, GLfloat alpha) const {
+    return glm::mix(_prevPositions[i], _positions[i], alpha);
+}
+
+GLfloat EnemyHorde::getRenderHeading(GLuint i, GLfloat alpha) const {
+    return FixedTimestep::interpolateAngle(_prevHeadings[i], _headings[i], alpha);
+}
+
+void EnemyHorde::killAll() {
+    for (GLubyte& flags : _flags) flags |= FLAG_DEAD;
+}
+
+void EnemyHorde::grow(GLuint i, glm::vec3 color) {
+    _colors[i] = color;
+    _scales[i] = GROWN_SCALE;
+    _positions[i].y = 1.0f;
+}
+
+glm::vec3 EnemyHorde::getStep(GLuint i, GLfloat dt) const {
+    const GLfloat ticks = dt * FixedTimestep::REFERENCE_TICK_RATE;
+    const GLfloat step = ticks * WALK_SPEED;
+    return glm::vec3(glm::cos(_headings[i]) * step, 0.0, -glm::sin(_headings[i]) * step);
+}
+
+void EnemyHorde::moveTo(GLuint i, glm::vec3 newPosition, GLfloat worldSize) {
+    newPosition.x = glm::clamp(newPosition.x, -worldSize, worldSize);
+    newPosition.z = glm::clamp(newPosition.z, -worldSize, worldSize);
+    _positions[i] = newPosition;
+}
+
+void EnemyHorde::storePreviousState() {
+    _prevPositions = _positions;
+    _prevHeadings = _headings;
+}
+
+void EnemyHorde::hover(GLfloat dt) {
+    const GLfloat ticks = dt * FixedTimestep::REFERENCE_TICK_RATE;
+    for (GLuint i = 0; i < getCount(); i++) {
+        if (_flags[i] & FLAG_DEAD) continue;
+        const auto hoverAmount = (GLfloat)(HOVER_HEIGHT * std::sin(M_PI / 180 * _hoverPhases[i]));
+        _positions[i].y += hoverAmount * 0.1f * ticks;
+        _hoverPhases[i] += ticks;
+    }
+}
+
+void EnemyHorde::sink(GLfloat distance) {
+    for (GLuint i = 0; i < getCount(); i++) {
+        if ((_flags[i] & (FLAG_DEAD | FLAG_FALLING)) == FLAG_FALLING) _positions[i].y -= distance;
+    }
+}
+
+void EnemyHorde::gatherLive(std::vector<glm::vec3>& positions, std::vector<GLuint>& indices) const {
+    for (GLuint i = 0; i < getCount(); i++) {
+        if (_flags[i] & FLAG_DEAD) continue;
+        positions.push_back(_positions[i]);
+        indices.push_back(i);
+    }
+}
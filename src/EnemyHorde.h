@@ -0,0 +1,91 @@
+#ifndef A5_ENEMY_HORDE_H
+#define A5_ENEMY_HORDE_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "FixedTimestep.h"
+
+/// \desc simulation state of every enemy, one array per field so the per-tick updates stream
+/// through memory.  How an enemy looks is the same for all of them and lives in Enemy
+class EnemyHorde {
+public:
+    /// \desc how far an enemy walks along its heading each reference tick
+    static constexpr GLfloat WALK_SPEED = 1.0f / 20.0f;
+
+    EnemyHorde();
+
+    /// \desc adds a live enemy standing still at a position
+    /// \returns index of the new enemy
+    GLuint add( glm::vec3 position, GLfloat heading );
+
+    /// \desc number of enemies, dead ones included
+    [[nodiscard]] GLuint getCount() const { return (GLuint)_positions.size(); }
+
+    [[nodiscard]] glm::vec3 getPosition( GLuint i ) const { return _positions[i]; }
+    [[nodiscard]] GLfloat getHeading( GLuint i ) const { return _headings[i]; }
+    /// \desc position blended between the previous and current tick
+    [[nodiscard]] glm::vec3 getRenderPos( GLuint i, GLfloat alpha ) const;
+    /// \desc heading blended between the previous and current tick
+    [[nodiscard]] GLfloat getRenderHeading( GLuint i, GLfloat alpha ) const;
+    /// \desc size of the enemy's body along each axis
+    [[nodiscard]] glm::vec3 getBodySize( GLuint i ) const { return glm::vec3(_scales[i]); }
+    [[nodiscard]] const glm::vec3& getColor( GLuint i ) const { return _colors[i]; }
+    /// \desc dead enemies are no longer drawn or simulated
+    [[nodiscard]] bool isDead( GLuint i ) const { return (_flags[i] & FLAG_DEAD) != 0; }
+    [[nodiscard]] bool isFalling( GLuint i ) const { return (_flags[i] & FLAG_FALLING) != 0; }
+
+    void setPosition( GLuint i, glm::vec3 position ) { _positions[i] = position; }
+    void setHeading( GLuint i, GLfloat heading ) { _headings[i] = heading; }
+    void setFalling( GLuint i ) { _flags[i] |= FLAG_FALLING; }
+    void kill( GLuint i ) { _flags[i] |= FLAG_DEAD; }
+    void killAll();
+
+    /// \desc recolors an enemy and doubles its size after it absorbs another
+    void grow( GLuint i, glm::vec3 color );
+
+    /// \desc how far one tick of walking forward carries an enemy along its heading
+    [[nodiscard]] glm::vec3 getStep( GLuint i, GLfloat dt ) const;
+    /// \desc moves an enemy to a position, held on the edge of the world if it lies past it
+    /// \param worldSize half the size of the world along x and z
+    void moveTo( GLuint i, glm::vec3 newPosition, GLfloat worldSize );
+
+    /// \desc remembers the current state of every enemy so rendering can blend from it once the
+    /// next tick runs
+    void storePreviousState();
+    /// \desc bobs every live enemy up and down
+    void hover( GLfloat dt );
+    /// \desc lowers every live enemy that is falling
+    /// \param distance how far they sink this tick
+    void sink( GLfloat distance );
+
+    /// \desc appends the position and index of every live enemy
+    void gatherLive( std::vector<glm::vec3>& positions, std::vector<GLuint>& indices ) const;
+
+private:
+    static constexpr GLubyte FLAG_DEAD = 0x1;
+    static constexpr GLubyte FLAG_FALLING = 0x2;
+    /// \desc size of a fresh enemy and of one that has absorbed another
+    static constexpr GLfloat START_SCALE = 10.0f;
+    static constexpr GLfloat GROWN_SCALE = 20.0f;
+    /// \desc height of the hover bob
+    static constexpr GLfloat HOVER_HEIGHT = 0.1f;
+
+    std::vector<glm::vec3> _positions;
+    std::vector<GLfloat> _headings;
+    std::vector<GLubyte> _flags;
+    /// \desc reference ticks the enemy has been hovering for, the bob is a sine of it
+    std::vector<GLfloat> _hoverPhases;
+
+    /// \desc state at the start of the current tick, blended towards when rendering
+    std::vector<glm::vec3> _prevPositions;
+    std::vector<GLfloat> _prevHeadings;
+
+    /// \desc per enemy appearance that changes during play
+    std::vector<GLfloat> _scales;
+    std::vector<glm::vec3> _colors;
+};
+
+#endif //A5_ENEMY_HORDE_H
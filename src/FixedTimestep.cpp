@@ -0,0 +1,35 @@
+#include "FixedTimestep.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+FixedTimestep::FixedTimestep(GLdouble ticksPerSecond) {
+    _tickLength = 1.0 / ticksPerSecond;
+    _accumulator = 0.0;
+}
+
+void FixedTimestep::setTickRate(GLdouble ticksPerSecond) {
+    _tickLength = 1.0 / ticksPerSecond;
+}
+
+void FixedTimestep::advance(GLdouble frameTime) {
+    _accumulator += glm::min(frameTime, MAX_FRAME_TIME);
+}
+
+bool FixedTimestep::consumeTick() {
+    if(_accumulator < _tickLength) return false;
+    _accumulator -= _tickLength;
+    return true;
+}
+
+GLfloat FixedTimestep::getAlpha() const {
+    return (GLfloat)(_accumulator / _tickLength);
+}
+
+GLfloat FixedTimestep::interpolateAngle(GLfloat from, GLfloat to, GLfloat alpha) {
+    // headings from atan2 wrap at +/- pi, so take the difference the short way around
+    GLfloat delta = to - from;
+    while(delta > glm::pi<float>()) delta -= glm::two_pi<float>();
+    while(delta < -glm::pi<float>()) delta += glm::two_pi<float>();
+    return from + delta * alpha;
+}
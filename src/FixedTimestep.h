@@ -0,0 +1,46 @@
+#ifndef A5_FIXED_TIMESTEP_H
+#define A5_FIXED_TIMESTEP_H
+
+#include "GLTypes.h"
+
+/// \desc accumulates wall clock time and hands it out in fixed size simulation ticks, so the
+/// game runs at the same speed no matter how fast frames are rendered
+class FixedTimestep {
+public:
+    /// \desc tick rate the per-tick movement amounts of the hero and enemies were tuned at.
+    /// Those amounts are scaled by dt * REFERENCE_TICK_RATE, the number of reference ticks a
+    /// tick of length dt covers, so the game plays the same at any tick rate
+    static constexpr GLdouble REFERENCE_TICK_RATE = 60.0;
+    /// \desc longest frame that is fed into the accumulator, stops a long stall from
+    /// queueing up more ticks than can be simulated in a frame
+    static constexpr GLdouble MAX_FRAME_TIME = 0.25;
+
+    /// \param ticksPerSecond number of simulation ticks per second
+    explicit FixedTimestep( GLdouble ticksPerSecond = REFERENCE_TICK_RATE );
+
+    /// \desc changes how many simulation ticks run per second
+    void setTickRate( GLdouble ticksPerSecond );
+    /// \desc length of a single tick in seconds
+    [[nodiscard]] GLdouble getTickLength() const { return _tickLength; }
+
+    /// \desc adds the time the last frame took to the accumulator
+    /// \param frameTime elapsed wall clock time in seconds
+    void advance( GLdouble frameTime );
+
+    /// \desc removes one tick from the accumulator if a whole tick is available
+    /// \returns true if the simulation should be stepped once more
+    bool consumeTick();
+
+    /// \desc how far between the previous and current tick the leftover time sits
+    /// \returns blend factor in [0, 1) to interpolate rendered state with
+    [[nodiscard]] GLfloat getAlpha() const;
+
+    /// \desc blends two angles along the shorter arc between them
+    static GLfloat interpolateAngle( GLfloat from, GLfloat to, GLfloat alpha );
+
+private:
+    GLdouble _tickLength;
+    GLdouble _accumulator;
+};
+
+#endif //A5_FIXED_TIMESTEP_H
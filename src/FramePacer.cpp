@@ -0,0 +1,107 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer() {
+    _targetFps = 0.0;
+    _framePeriod = 0.0;
+    _nextFrame = Clock::now();
+    _lastFrame = _nextFrame;
+    _totalFrames = 0;
+    _lateFrames = 0;
+    _sleepMean = SLEEP_SLICE_SECONDS;
+    _sleepVariance = 0.0;
+    _sleepCount = 0;
+    _intervals.reserve(WINDOW_SIZE);
+    _nextInterval = 0;
+}
+
+void FramePacer::setTargetFps(GLdouble framesPerSecond) {
+    _targetFps = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+    _framePeriod = _targetFps > 0.0 ? 1.0 / _targetFps : 0.0;
+    _nextFrame = Clock::now();
+}
+
+void FramePacer::wait() {
+    Clock::time_point now = Clock::now();
+    if (_framePeriod > 0.0) {
+        _sleepUntil(_nextFrame);
+        now = Clock::now();
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<GLdouble>(_framePeriod));
+        if (_totalFrames > 0 && now - _nextFrame > period / 2) {
+            _lateFrames++;
+        }
+        // deadlines stay on a fixed grid so small overshoots do not add up, unless a stall left
+        // us a whole frame behind, which would otherwise be followed by a burst of frames
+        _nextFrame += period;
+        if (_nextFrame < now) {
+            _nextFrame = now + period;
+        }
+    }
+
+    if (_totalFrames > 0) {
+        const GLdouble interval = std::chrono::duration<GLdouble, std::milli>(now - _lastFrame).count();
+        if (_intervals.size() < WINDOW_SIZE) {
+            _intervals.push_back(interval);
+        } else {
+            _intervals[_nextInterval] = interval;
+        }
+        _nextInterval = (_nextInterval + 1) % WINDOW_SIZE;
+    }
+    _lastFrame = now;
+    _totalFrames++;
+}
+
+void FramePacer::_sleepUntil(Clock::time_point deadline) {
+    const auto slice = std::chrono::duration<GLdouble>(SLEEP_SLICE_SECONDS);
+    while (true) {
+        // a slice can oversleep by however long the scheduler takes to wake us, so only sleep
+        // while even a pessimistic slice ends before the deadline
+        const GLdouble remaining = std::chrono::duration<GLdouble>(deadline - Clock::now()).count();
+        if (remaining <= _sleepMean + std::sqrt(_sleepVariance)) break;
+
+        const Clock::time_point start = Clock::now();
+        std::this_thread::sleep_for(slice);
+        const GLdouble observed = std::chrono::duration<GLdouble>(Clock::now() - start).count();
+
+        // exponentially weighted once the history is full
+        if (_sleepCount < SLEEP_HISTORY) _sleepCount++;
+        const GLdouble weight = 1.0 / (GLdouble)_sleepCount;
+        const GLdouble delta = observed - _sleepMean;
+        _sleepMean += weight * delta;
+        _sleepVariance = (1.0 - weight) * (_sleepVariance + weight * delta * delta);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+FramePacer::JitterStats FramePacer::getStats() const {
+    JitterStats stats = {_totalFrames, _lateFrames, (GLuint)_intervals.size(), 0.0, 0.0, 0.0, 0.0};
+    if (_intervals.empty()) return stats;
+
+    std::vector<GLdouble> sorted = _intervals;
+    std::sort(sorted.begin(), sorted.end());
+    GLdouble total = 0.0;
+    for (GLdouble interval : sorted) total += interval;
+    stats.avgMs = total / (GLdouble)sorted.size();
+    GLdouble squares = 0.0;
+    for (GLdouble interval : sorted) squares += (interval - stats.avgMs) * (interval - stats.avgMs);
+    stats.stdDevMs = std::sqrt(squares / (GLdouble)sorted.size());
+    // nearest rank, matching the profiler's percentiles
+    auto rank = (size_t)((GLdouble)sorted.size() * 0.99);
+    stats.p99Ms = sorted[std::min(rank, sorted.size() - 1)];
+    stats.maxMs = sorted.back();
+    return stats;
+}
+
+void FramePacer::printStats(FILE* stream) const {
+    const JitterStats stats = getStats();
+    fprintf(stream, "[INFO]: Frame pacing - target %.1f fps, %u frames, %u late, interval avg %.3f ms, "
+                    "std dev %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            _targetFps, stats.totalFrames, stats.lateFrames, stats.avgMs, stats.stdDevMs, stats.p99Ms, stats.maxMs);
+}
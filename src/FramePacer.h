@@ -0,0 +1,95 @@
+#ifndef A5_FRAME_PACER_H
+#define A5_FRAME_PACER_H
+
+#include "GLTypes.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/// \desc holds frames to a target rate and measures how evenly they are delivered.  Waits
+/// sleep for most of the time left and spin through the last stretch, so the cap is precise
+/// without burning a core for the whole frame
+class FramePacer {
+public:
+    /// \desc how buffer swaps wait for the display, the values are the matching swap intervals
+    enum class VsyncMode : GLint {
+        /// \desc swap as soon as the frame is done, may tear
+        OFF = 0,
+        /// \desc wait for the next vertical blank
+        ON = 1,
+        /// \desc wait for the vertical blank unless the frame is already late, then swap at once
+        ADAPTIVE = -1
+    };
+
+    /// \desc number of most recent frame intervals the jitter statistics are computed over
+    static constexpr GLuint WINDOW_SIZE = 300;
+
+    /// \desc how evenly frames have been delivered, all times in milliseconds
+    struct JitterStats {
+        /// \desc frames paced since the program started
+        GLuint totalFrames;
+        /// \desc frames that started more than half a frame after they were due, only counted
+        /// while a target rate is set
+        GLuint lateFrames;
+        /// \desc number of intervals the statistics below are taken over
+        GLuint numSamples;
+        GLdouble avgMs;
+        /// \desc standard deviation of the interval between frames
+        GLdouble stdDevMs;
+        GLdouble p99Ms;
+        GLdouble maxMs;
+    };
+
+    FramePacer();
+
+    /// \desc caps how many frames start per second
+    /// \param framesPerSecond target rate, 0 leaves frames uncapped
+    void setTargetFps( GLdouble framesPerSecond );
+    [[nodiscard]] GLdouble getTargetFps() const { return _targetFps; }
+
+    /// \desc blocks until the next frame is due and records when it started, call once at the
+    /// start of every frame
+    void wait();
+
+    /// \desc statistics of the intervals between recent frames
+    [[nodiscard]] JitterStats getStats() const;
+
+    /// \desc writes the jitter statistics on a single line
+    void printStats( FILE* stream ) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// \desc sleeps in short slices while the time left is longer than a slice is expected to
+    /// take, then spins until the deadline
+    void _sleepUntil( Clock::time_point deadline );
+
+    /// \desc length of one sleep slice
+    static constexpr GLdouble SLEEP_SLICE_SECONDS = 0.001;
+    /// \desc most slices the oversleep estimate averages over, keeps it following the scheduler
+    /// as the machine's load changes over a long run
+    static constexpr GLuint SLEEP_HISTORY = 64;
+
+    GLdouble _targetFps;
+    /// \desc seconds between frames at the target rate, 0 when uncapped
+    GLdouble _framePeriod;
+    /// \desc when the next frame is due
+    Clock::time_point _nextFrame;
+    /// \desc when the last frame started
+    Clock::time_point _lastFrame;
+    GLuint _totalFrames;
+    GLuint _lateFrames;
+
+    /// \desc running mean and variance of how long a slice actually sleeps, in seconds
+    GLdouble _sleepMean;
+    GLdouble _sleepVariance;
+    GLuint _sleepCount;
+
+    /// \desc ring buffer of the last WINDOW_SIZE intervals between frames in milliseconds
+    std::vector<GLdouble> _intervals;
+    /// \desc position in _intervals the next interval is written to
+    GLuint _nextInterval;
+};
+
+#endif //A5_FRAME_PACER_H
@@ -0,0 +1,56 @@
+#include "FrustumCuller.h"
+
+FrustumCuller::FrustumCuller() {
+    // until the first frame everything is treated as visible
+    for(auto& plane : _planes) plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    _visibleCount = 0;
+    _culledCount = 0;
+}
+
+void FrustumCuller::beginFrame(glm::mat4 viewProjMtx) {
+    // Gribb-Hartmann: each plane is the last row of the matrix plus or minus one of the other rows
+    glm::vec4 rows[4];
+    for(int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjMtx[0][i], viewProjMtx[1][i], viewProjMtx[2][i], viewProjMtx[3][i]);
+    }
+    _planes[0] = rows[3] + rows[0];
+    _planes[1] = rows[3] - rows[0];
+    _planes[2] = rows[3] + rows[1];
+    _planes[3] = rows[3] - rows[1];
+    _planes[4] = rows[3] + rows[2];
+    _planes[5] = rows[3] - rows[2];
+    for(auto& plane : _planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    _visibleCount = 0;
+    _culledCount = 0;
+}
+
+bool FrustumCuller::isBoxVisible(const AABB& box) {
+    for(const auto& plane : _planes) {
+        // only the corner furthest along the plane normal needs testing
+        glm::vec3 farthestCorner( plane.x >= 0.0f ? box.maxCorner.x : box.minCorner.x,
+                                  plane.y >= 0.0f ? box.maxCorner.y : box.minCorner.y,
+                                  plane.z >= 0.0f ? box.maxCorner.z : box.minCorner.z );
+        if(glm::dot(glm::vec3(plane), farthestCorner) + plane.w < 0.0f) {
+            return _count(false);
+        }
+    }
+    return _count(true);
+}
+
+bool FrustumCuller::isSphereVisible(glm::vec3 center, GLfloat radius) {
+    for(const auto& plane : _planes) {
+        if(glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return _count(false);
+        }
+    }
+    return _count(true);
+}
+
+bool FrustumCuller::_count(bool visible) {
+    if(visible) _visibleCount++;
+    else _culledCount++;
+    return visible;
+}
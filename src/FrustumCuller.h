@@ -0,0 +1,44 @@
+#ifndef A5_FRUSTUM_CULLER_H
+#define A5_FRUSTUM_CULLER_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+
+/// \desc rejects bounding volumes that lie completely outside the camera's view frustum
+/// and counts how many passed and failed so the savings can be measured
+class FrustumCuller {
+public:
+    FrustumCuller();
+
+    /// \desc extracts the six frustum planes for this frame and resets the counters
+    /// \param viewProjMtx combined projection * view matrix of the camera
+    void beginFrame( glm::mat4 viewProjMtx );
+
+    /// \desc tests an axis aligned box against the frustum
+    /// \returns true if any part of the box may be visible
+    bool isBoxVisible( const AABB& box );
+
+    /// \desc tests a sphere against the frustum
+    /// \returns true if any part of the sphere may be visible
+    bool isSphereVisible( glm::vec3 center, GLfloat radius );
+
+    /// \desc number of volumes that passed the test since beginFrame
+    [[nodiscard]] GLuint getVisibleCount() const { return _visibleCount; }
+    /// \desc number of volumes that were rejected since beginFrame
+    [[nodiscard]] GLuint getCulledCount() const { return _culledCount; }
+
+private:
+    /// \desc left, right, bottom, top, near, far planes as (normal, distance) with unit length normals
+    glm::vec4 _planes[6];
+
+    GLuint _visibleCount;
+    GLuint _culledCount;
+
+    /// \desc bumps the matching counter and passes the result through
+    bool _count( bool visible );
+};
+
+#endif //A5_FRUSTUM_CULLER_H
@@ -0,0 +1,13 @@
+#ifndef A5_GL_TYPES_H
+#define A5_GL_TYPES_H
+
+/// \desc the GL scalar type names the game rules are written with, declared without a GL header
+/// so the core library builds and runs on a machine with no GL installed.  They are the same
+/// types GL declares, so files that include both see no conflict
+typedef float GLfloat;
+typedef double GLdouble;
+typedef int GLint;
+typedef unsigned int GLuint;
+typedef unsigned char GLubyte;
+
+#endif //A5_GL_TYPES_H
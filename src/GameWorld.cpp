@@ -0,0 +1,285 @@
+#include "GameWorld.h"
+#include "Profiler.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+GameWorld::GameWorld(GLuint numEnemies, GLuint seed)
+        : GameWorld(Config{numEnemies, 6, 6, Walls::NUM_LAYOUT_WALLS, seed}) {
+}
+
+GameWorld::GameWorld(const Config& config)
+        : _walls(config.numWalls),
+          _tileGrid(config.tileColumns, config.tileRows),
+          _enemyHash(TOUCH_CELL_SIZE),
+          _config(config) {
+    if( _config.seed == 0 ) _config.seed = (GLuint)time(nullptr);
+    srand( _config.seed );                                              // seed our RNG
+
+    // leave the same margin around the tiles as the standard 6x6 grid has
+    GLuint widestSide = glm::max(config.tileColumns, config.tileRows);
+    GLfloat gridHalfSize = (GLfloat)(widestSide > 0 ? widestSide - 1 : 0) * TileGrid::TILE_SPACING / 2.0f;
+    _worldSize = glm::max(WORLD_SIZE, gridHalfSize + 10.0f);
+
+    _won = false;
+    _finished = false;
+    _tickCount = 0;
+
+    for(GLuint i = 0; i < config.numEnemies; i++) {
+        _spawnEnemy();
+    }
+
+    _generateTiles();
+    _scatterWalls(config.numWalls);
+    // the walls never move after this, so their hierarchy is only built once
+    _walls.buildHierarchy();
+}
+
+void GameWorld::step(const Input& input, GLfloat dt) {
+    const auto ticks = (GLfloat)(dt * FixedTimestep::REFERENCE_TICK_RATE);
+    _tickCount++;
+
+    // rendering blends from the state at the start of this tick
+    _hero.storePreviousState();
+    _enemies.storePreviousState();
+
+    {
+        A5_PROFILE_SCOPE("sim.movement");
+        // Handle the hero's forward movement and checks for environment boundaries.
+        if(input.moveForward) {
+            _moveHero(_hero.getStep(dt));
+            if(_isOffWorld(_hero.getCurrPos())) {
+                _hero.setFalling(true);
+            }
+        }
+
+        // Handle the hero's backward movement and checks for environment boundaries.
+        if(input.moveBackward) {
+            _moveHero(-_hero.getStep(dt));
+            if(_isOffWorld(_hero.getCurrPos())) {
+                _hero.setFalling(true);
+            }
+        }
+    }
+
+    // Rotates the hero's heading left or right.
+    if(input.turnRight) {
+        _hero.turnRight(dt);
+    }
+
+    if(input.turnLeft) {
+        _hero.turnLeft(dt);
+    }
+
+    // Create hero and enemy idle movements.
+    _hero.idleMovement(dt);
+    {
+        A5_PROFILE_SCOPE("sim.tiles");
+        _isOnTile(_hero.getCurrPos());
+        _isWinner(dt);
+    }
+
+    _enemies.hover(dt);
+
+    // Falling characters sink a little further every tick.
+    if (_hero.getFalling()) {
+        _hero.setHeroPosition(_hero.getCurrPos() - glm::vec3(0, 0.3f * ticks, 0));
+    }
+    _enemies.sink(0.3f * ticks);
+
+    // Check if the hero has fallen off the map a certain amount to end the game.
+    if ( _hero.getCurrPos().y < -50.0f ) {
+        _finished = true;
+    }
+
+    // Creates the Enemy following the hero where ever he goes by checking the direction.
+    {
+        A5_PROFILE_SCOPE("sim.movement");
+        _moveEnemies(dt);
+    }
+
+    // Checks for any collisions.
+    {
+        A5_PROFILE_SCOPE("sim.collisions");
+        _buildEnemyHash();
+        _isCollisionEnemies();
+        _isCollisionEnemyHero(dt);
+    }
+
+    // Makes sure the enemy can fall off the map the same way the hero can.
+    for(GLuint i = 0; i < _enemies.getCount(); i++) {
+        if(!_enemies.isDead(i) && _isOffWorld(_enemies.getPosition(i))) {
+            _enemies.setFalling(i);
+        }
+    }
+}
+
+GLubyte GameWorld::Input::toBits() const {
+    return (GLubyte)((moveForward ? 0x1 : 0) | (moveBackward ? 0x2 : 0) | (turnLeft ? 0x4 : 0) | (turnRight ? 0x8 : 0));
+}
+
+GameWorld::Input GameWorld::Input::fromBits(GLubyte bits) {
+    return { (bits & 0x1) != 0, (bits & 0x2) != 0, (bits & 0x4) != 0, (bits & 0x8) != 0 };
+}
+
+void GameWorld::_generateTiles() {
+    const auto tileColumns = (GLint)_tileGrid.getColumns();
+    const auto tileRows = (GLint)_tileGrid.getRows();
+    _tiles.reserve(_tileGrid.getTileCount());
+    _tileVisited.assign(_tileGrid.getTileCount(), false);
+    _visitedTileCount = 0;
+    // psych! everything's on a grid.  Grid coordinates step by two so the tiles sit one
+    // tile apart, and the grid is centered on the origin.  Tiles are stored in the grid's order.
+    for(GLint column = 0; column < tileColumns; column++) {
+        for(GLint row = 0; row < tileRows; row++) {
+            GLint i = 2 * column - (tileColumns - 1);
+            GLint j = 2 * row - (tileRows - 1);
+
+            // translate to spot
+            glm::mat4 transToSpotMtx = glm::translate( glm::mat4(1.0), glm::vec3(i, 0.0f, j) );
+
+            // compute height
+            GLdouble height = 0.3f;
+            // scale to tile size
+            glm::mat4 scaleToHeightMtx = glm::scale( glm::mat4(1.0), glm::vec3(9, height, 9) );
+
+            // translate up to grid
+            glm::mat4 transToHeight = glm::translate( glm::mat4(1.0), glm::vec3(0, height/2.0f, 0) );
+
+            // compute full model matrix
+            glm::mat4 modelMatrix = transToHeight * scaleToHeightMtx * transToSpotMtx;
+
+            // compute color
+            glm::vec3 color( 0.4f, 0.4f, 0.4f );
+            // store tile properties
+            Tile currentTile = {modelMatrix, color, _tileGrid.getCenter((GLuint)column, (GLuint)row)};
+            _tiles.emplace_back(currentTile);
+        }
+    }
+}
+
+void GameWorld::_scatterWalls(GLuint numWalls) {
+    const glm::vec3 pillarSize(3.0f, 5.0f, 3.0f);
+    const GLfloat range = _worldSize - pillarSize.x;
+    for(GLuint i = Walls::NUM_LAYOUT_WALLS; i < numWalls; i++) {
+        glm::vec3 position;
+        do {
+            position = glm::vec3(((GLfloat)rand() / (GLfloat)RAND_MAX * 2.0f - 1.0f) * range, 0.0f,
+                                 ((GLfloat)rand() / (GLfloat)RAND_MAX * 2.0f - 1.0f) * range);
+            // a pillar on top of the hero would pin him in place
+        } while(AABB::fromCenterSize(position, pillarSize * 2.0f).containsXZ(_hero.getCurrPos()));
+        _walls.addWall(position, pillarSize);
+    }
+}
+
+void GameWorld::_spawnEnemy() {
+    const GLuint enemyIndex = _enemies.getCount();
+    if(enemyIndex == 0) {
+        _enemies.add(glm::vec3(45, 0, -45), FIRST_ENEMY_HEADING);
+    } else if(enemyIndex == 1) {
+        _enemies.add(glm::vec3(-45, 0, 45), SECOND_ENEMY_HEADING);
+    } else {
+        // any extra enemies are spread around the outer ring of the world
+        GLfloat angle = (GLfloat)enemyIndex * 2.39996f;
+        _enemies.add(glm::vec3(45.0f * glm::cos(angle), 0, 45.0f * glm::sin(angle)), angle + glm::pi<float>());
+    }
+}
+
+void GameWorld::_isOnTile(glm::vec3 currPos) {
+    const glm::vec3 visitedColor(0.0, 1.0, 0.0);
+    // the grid finds the one tile that can be underfoot, however many tiles there are
+    const GLint tileIndex = _tileGrid.findTile(currPos);
+    if (tileIndex == TileGrid::NO_TILE) return;
+
+    // only a first visit changes anything
+    if (_tileVisited[tileIndex]) return;
+    _tileVisited[tileIndex] = true;
+    _visitedTileCount++;
+    _tiles[tileIndex].color = visitedColor;
+    _changedTiles.push_back((GLuint)tileIndex);
+
+    // the count only moves here, so this is the one place the game can be won
+    if (_visitedTileCount == _tiles.size()) {
+        _won = true;
+    }
+}
+
+// Creates how the hero grows in size and kills the enemies if the hero has visited all tiles.
+void GameWorld::_isWinner(GLfloat dt) {
+    if ( _won ) {
+        _hero.setHeroWinner(dt);
+        _enemies.killAll();
+        if ( _hero.getBodySize().x > 15.0f ) {
+            _hero.setHeroSize();
+        }
+    }
+}
+
+// Creates the hero shrinking and ending the game if he gets touched by the enemy too much.
+void GameWorld::_isLoser(GLfloat dt) {
+    _hero.setHeroLoser(dt);
+    if ( _hero.getBodySize().x < 1.0f ) {
+        _finished = true;
+    }
+}
+
+bool GameWorld::_isOffWorld(glm::vec3 currPos) const {
+    // movers are held on the edge once they reach it, so standing on it is already off
+    return currPos.x >= _worldSize || currPos.x <= -_worldSize || currPos.z >= _worldSize || currPos.z <= -_worldSize;
+}
+
+// Movers are swept against the walls, so they stop at the first wall in their way and slide
+// along it instead of stepping into it and being pushed back out.
+void GameWorld::_moveHero(glm::vec3 step) {
+    _hero.moveTo(_walls.getHierarchy().sweepXZ(_hero.getCurrPos(), step), _worldSize);
+}
+
+void GameWorld::_moveEnemies(GLfloat dt) {
+    const glm::vec3 heroPos = _hero.getCurrPos();
+    for(GLuint i = 0; i < _enemies.getCount(); i++) {
+        if(_enemies.isDead(i)) continue;
+        glm::vec3 directionToHero = glm::normalize(heroPos - _enemies.getPosition(i));
+        _enemies.setHeading(i, std::atan2(-directionToHero.z, directionToHero.x));
+        _enemies.moveTo(i, _walls.getHierarchy().sweepXZ(_enemies.getPosition(i), _enemies.getStep(i, dt)), _worldSize);
+    }
+}
+
+void GameWorld::_buildEnemyHash() {
+    _moverPositions.clear();
+    _moverIndices.clear();
+    _enemies.gatherLive(_moverPositions, _moverIndices);
+    _enemyHash.build(_moverPositions.data(), _moverIndices.data(), (GLuint)_moverPositions.size());
+}
+
+// When two enemies run into each other the first one absorbs the second.
+// Pairs come sorted, so merges happen in the same order as testing every pair would give.
+void GameWorld::_isCollisionEnemies() {
+    _enemyHash.findPairs(_enemyPairs);
+    for (const SpatialHash::Pair& pair : _enemyPairs) {
+        const GLuint i = pair.first, j = pair.second;
+        // an earlier merge this tick may have absorbed either of them
+        if (_enemies.isDead(i) || _enemies.isDead(j)) continue;
+        if (_isTouching(_enemies.getPosition(i), _enemies.getPosition(j))) {
+            _enemies.kill(j);
+            _enemies.grow(i, glm::vec3(0,0,1));
+        }
+    }
+}
+
+void GameWorld::_isCollisionEnemyHero(GLfloat dt) {
+    _enemyHash.query(_hero.getCurrPos(), _nearbyEnemies);
+    for (GLuint i : _nearbyEnemies) {
+        if (!_enemies.isDead(i) && _isTouching(_enemies.getPosition(i), _hero.getCurrPos())) {
+            // the hero only shrinks once a tick no matter how many enemies touch him
+            _isLoser(dt);
+            return;
+        }
+    }
+}
+
+bool GameWorld::_isTouching(glm::vec3 first, glm::vec3 second) {
+    return (first.x + 1 > second.x - 1) && (first.x - 1 < second.x + 1) && (first.z + 1 > second.z - 1) && (first.z - 1 < second.z + 1);
+}
@@ -0,0 +1,173 @@
+#ifndef A5_GAME_WORLD_H
+#define A5_GAME_WORLD_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <vector>
+
+#include "EnemyHorde.h"
+#include "Hero.h"
+#include "SpatialHash.h"
+#include "TileGrid.h"
+#include "Walls.h"
+
+/// \desc all of the game state and rules with no window or GL context, so it can be stepped
+/// by the engine or by a headless driver alike
+class GameWorld {
+public:
+    /// \desc controls held down during a tick
+    struct Input {
+        bool moveForward;
+        bool moveBackward;
+        bool turnLeft;
+        bool turnRight;
+
+        /// \desc packs the controls one per bit, forward is the lowest
+        [[nodiscard]] GLubyte toBits() const;
+        /// \desc unpacks controls packed by toBits
+        static Input fromBits( GLubyte bits );
+    };
+
+    /// \desc state of a single floor tile
+    struct Tile {
+        /// \desc transformations to position and size the tile
+        glm::mat4 modelMatrix;
+        /// \desc color to draw the tile, turns green once the hero visits it
+        glm::vec3 color;
+        /// \desc world space center of the tile
+        glm::vec3 location;
+    };
+
+    /// \desc how big a world to build, the defaults are the standard game
+    struct Config {
+        /// \desc number of enemies chasing the hero
+        GLuint numEnemies = 2;
+        /// \desc tiles along x
+        GLuint tileColumns = 6;
+        /// \desc tiles along z
+        GLuint tileRows = 6;
+        /// \desc wall segments, the standard layout first and then pillars scattered by the seed
+        GLuint numWalls = Walls::NUM_LAYOUT_WALLS;
+        /// \desc seed for the random number generator, 0 picks one from the clock
+        GLuint seed = 0;
+    };
+
+    /// \desc half the size of the standard world, anything past the edge falls off
+    static constexpr GLfloat WORLD_SIZE = 55.0f;
+    /// \desc bump whenever a change to the rules makes the same controls play out differently,
+    /// recordings made under another version are refused instead of silently replaying wrong
+    static constexpr GLuint SIMULATION_VERSION = 1;
+
+    /// \desc lays out the tiles and walls and spawns the hero and enemies
+    /// \param numEnemies number of enemies chasing the hero
+    /// \param seed seed for the random number generator, 0 picks one from the clock
+    explicit GameWorld( GLuint numEnemies = 2, GLuint seed = 0 );
+    /// \desc builds a world of any size, used to measure how each rule scales
+    explicit GameWorld( const Config& config );
+
+    /// \desc advances every rule by one tick
+    /// \param input controls held down during the tick
+    /// \param dt length of the tick in seconds
+    void step( const Input& input, GLfloat dt );
+
+    [[nodiscard]] const Hero& getHero() const { return _hero; }
+    [[nodiscard]] const EnemyHorde& getEnemies() const { return _enemies; }
+    [[nodiscard]] const Walls& getWalls() const { return _walls; }
+    /// \desc every tile, indexed as laid out by getTileGrid
+    [[nodiscard]] const std::vector<Tile>& getTiles() const { return _tiles; }
+    [[nodiscard]] const TileGrid& getTileGrid() const { return _tileGrid; }
+
+    /// \desc indices of the tiles whose color changed, oldest first, since they were last forgotten.
+    /// A tile only changes on its first visit, so the list never holds more entries than there
+    /// are tiles and nothing has to empty it, SimulationThread trims it as snapshots are drawn
+    [[nodiscard]] const std::vector<GLuint>& getChangedTiles() const { return _changedTiles; }
+    /// \desc drops the oldest changes once whoever reads them has seen them
+    /// \param count number of changes to drop from the front of getChangedTiles
+    void forgetChangedTiles( GLuint count ) { _changedTiles.erase(_changedTiles.begin(), _changedTiles.begin() + count); }
+
+    /// \desc number of tiles the hero has visited
+    [[nodiscard]] GLuint getVisitedTileCount() const { return _visitedTileCount; }
+    /// \desc true once the hero has stepped on a tile
+    [[nodiscard]] bool isTileVisited( GLuint tileIndex ) const { return _tileVisited[tileIndex]; }
+    /// \desc true once every tile has been visited
+    [[nodiscard]] bool hasWon() const { return _won; }
+    /// \desc true once the hero has fallen off the world or shrunk away, the game should end
+    [[nodiscard]] bool isFinished() const { return _finished; }
+    /// \desc half the size of this world, grows past WORLD_SIZE when the tile grid needs the room
+    [[nodiscard]] GLfloat getWorldSize() const { return _worldSize; }
+    /// \desc seed the random number generator was started with, replays need it to match
+    [[nodiscard]] GLuint getSeed() const { return _config.seed; }
+    /// \desc settings the world was built with, including the seed actually used
+    [[nodiscard]] const Config& getConfig() const { return _config; }
+    /// \desc number of ticks stepped so far
+    [[nodiscard]] GLuint getTickCount() const { return _tickCount; }
+
+private:
+    /// \desc A5Bench times the rules below on their own
+    friend class GameWorldBench;
+
+    Hero _hero;
+    EnemyHorde _enemies;
+    Walls _walls;
+    /// \desc maps positions to tiles, _tiles is stored in its order
+    TileGrid _tileGrid;
+    std::vector<Tile> _tiles;
+    /// \desc parallel to _tiles, set the first time the hero steps on a tile
+    std::vector<bool> _tileVisited;
+    /// \desc number of set entries in _tileVisited
+    GLuint _visitedTileCount;
+    std::vector<GLuint> _changedTiles;
+    /// \desc scratch space for gathering the live enemies, kept to avoid allocating every tick
+    std::vector<glm::vec3> _moverPositions;
+    std::vector<GLuint> _moverIndices;
+    /// \desc live enemies bucketed by position, rebuilt every tick once they have moved
+    SpatialHash _enemyHash;
+    /// \desc scratch space for the neighbors the enemy hash finds
+    std::vector<SpatialHash::Pair> _enemyPairs;
+    std::vector<GLuint> _nearbyEnemies;
+    /// \desc cell size of the enemy hash.  Footprints touch within 2 units along both axes, the
+    /// extra half unit covers the rounding in _isTouching
+    static constexpr GLfloat TOUCH_CELL_SIZE = 2.5f;
+    /// \desc headings of the two standard enemies as they spawn, facing -x and -z
+    static constexpr GLfloat FIRST_ENEMY_HEADING = glm::pi<float>();
+    static constexpr GLfloat SECOND_ENEMY_HEADING = glm::half_pi<float>();
+
+    Config _config;
+    GLfloat _worldSize;
+    bool _won;
+    bool _finished;
+    GLuint _tickCount;
+
+    /// \desc generates tiles information to make up our scene
+    void _generateTiles();
+    /// \desc scatters square pillars over the world at spots picked by the seeded generator
+    void _scatterWalls( GLuint numWalls );
+    /// \desc adds the next enemy at its spawn point facing into the world
+    void _spawnEnemy();
+
+    // Functions for how the game works and if you won or lost.
+    /// \desc marks the tile under a position visited, and wins the game once every tile is
+    void _isOnTile( glm::vec3 currPos );
+    /// \desc grows the hero and clears out the enemies every tick after the game is won
+    void _isWinner( GLfloat dt );
+    void _isLoser( GLfloat dt );
+    /// \desc checks if a position has crossed the edge of the world
+    [[nodiscard]] bool _isOffWorld( glm::vec3 currPos ) const;
+
+    // Functions for collision checking.
+    /// \desc walks the hero as far as the walls let it, sliding along any it runs into
+    /// \param step how far the hero tries to move this tick
+    void _moveHero( glm::vec3 step );
+    /// \desc turns every live enemy towards the hero and walks it as far as the walls let it
+    void _moveEnemies( GLfloat dt );
+    /// \desc buckets every live enemy by where it is now
+    void _buildEnemyHash();
+    void _isCollisionEnemies();
+    void _isCollisionEnemyHero( GLfloat dt );
+    /// \desc the 2x2 footprints of two characters overlap
+    [[nodiscard]] static bool _isTouching( glm::vec3 first, glm::vec3 second );
+};
+
+#endif //A5_GAME_WORLD_H
@@ -0,0 +1,37 @@
+#include "GpuTimer.h"
+#include "Profiler.h"
+
+GpuTimer::GpuTimer(const char* zoneName) {
+    glGenQueries(NUM_QUERIES, _queries);
+    for (bool& pending : _pending) pending = false;
+    _currentQuery = 0;
+    _zoneId = Profiler::instance().registerZone(zoneName);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(NUM_QUERIES, _queries);
+}
+
+void GpuTimer::begin() {
+    GLuint query = _queries[_currentQuery];
+    if (_pending[_currentQuery]) {
+        // only read the result once the GPU says it is there, waiting on it would stall the frame
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+            Profiler::instance().addSample(_zoneId, (GLdouble)elapsedNs / 1.0e6);
+        } else {
+            Profiler::instance().addDroppedSample(_zoneId);
+        }
+        _pending[_currentQuery] = false;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, query);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    _pending[_currentQuery] = true;
+    _currentQuery = (_currentQuery + 1) % NUM_QUERIES;
+}
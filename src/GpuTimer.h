@@ -0,0 +1,33 @@
+#ifndef A5_GPU_TIMER_H
+#define A5_GPU_TIMER_H
+
+#include <GL/glew.h>
+
+/// \desc times GPU work with GL_TIME_ELAPSED queries and adds the results to a Profiler zone.
+/// Two queries are alternated so a result is read a frame after it was issued, by which time
+/// it is normally ready and reading it never stalls the pipeline.  A result still not ready by
+/// then is counted as dropped in the zone
+/// \note GL_TIME_ELAPSED queries cannot nest, only one GpuTimer may be running at a time
+class GpuTimer {
+public:
+    /// \desc creates the queries, needs a current GL context
+    /// \param zoneName profiler zone the timings are added to
+    explicit GpuTimer( const char* zoneName );
+    ~GpuTimer();
+
+    /// \desc collects the result of the query about to be reused, then starts timing
+    void begin();
+    /// \desc stops timing, the result is collected the next time this query comes around
+    void end();
+
+private:
+    static constexpr GLuint NUM_QUERIES = 2;
+    GLuint _queries[NUM_QUERIES];
+    /// \desc the query has been issued and its result not yet read
+    bool _pending[NUM_QUERIES];
+    /// \desc query used by the next begin
+    GLuint _currentQuery;
+    GLuint _zoneId;
+};
+
+#endif //A5_GPU_TIMER_H
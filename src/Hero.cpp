@@ -1,16 +1,9 @@
 #include "Hero.h"
+#include "MeshBuilder.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
-#include <CSCI441/objects.hpp>
-#include <CSCI441/OpenGLUtils.hpp>
-
-Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation ) {
-    _shaderProgramHandle                            = shaderProgramHandle;
-    _shaderProgramUniformLocations.mvpMtx           = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx        = normalMtxUniformLocation;
-    _shaderProgramUniformLocations.materialColor    = materialColorUniformLocation;
-
+Hero::Hero() {
     _currPos = glm::vec3(-36, 2.2, -45);
     _falling = false;
 
@@ -19,7 +12,6 @@ Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normal
     _hoverAmount = 0.0;
 
     // Initializes all of our matrix calculations to draw our hero's body.
-    _transWholeBody = glm::vec3( 0.0f, 2.2f, 0.0f);
     _scaleWholeBody = glm::vec3( 10.0f, 10.0f, 10.0f);
     _bodyAngle = 0.0f;
     _bodyAngleRotationFactor = _PI / 64;
@@ -46,23 +38,36 @@ Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normal
 
     _colorArm = glm::vec3( 0.8f, 0.8f, 0.8f );
     _scaleArm = glm::vec3(0.5f, 1.0f, 1.0f );
+
+    storePreviousState();
 }
 
-glm::vec3 Hero::getCurrPos() {
+glm::vec3 Hero::getCurrPos() const {
     return _currPos;
 }
 
-// Main function to put together the hero and draw it as a whole.
-void Hero::drawHero(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) {
-    modelMtx = glm::translate(modelMtx, _currPos);
-    modelMtx = glm::rotate( modelMtx, _bodyAngle, CSCI441::Y_AXIS );
-    modelMtx = glm::scale( modelMtx, _scaleWholeBody );
-    _drawHeroBody(modelMtx, viewMtx, projMtx);
-    _drawHeroArm(modelMtx, viewMtx, projMtx);
-    _drawHeroLegs(modelMtx, viewMtx, projMtx);
-    _drawHeroHead(modelMtx, viewMtx, projMtx);
-    _drawHeroLeftEye(modelMtx, viewMtx, projMtx);
-    _drawHeroRightEye(modelMtx, viewMtx, projMtx);
+glm::vec3 Hero::getRenderPos(GLfloat alpha) const {
+    return glm::mix(_prevPos, _currPos, alpha);
+}
+
+GLfloat Hero::getRenderBodyAngle(GLfloat alpha) const {
+    return FixedTimestep::interpolateAngle(_prevBodyAngle, _bodyAngle, alpha);
+}
+
+glm::vec3 Hero::getRenderBodySize(GLfloat alpha) const {
+    return glm::mix(_prevScaleWholeBody, _scaleWholeBody, alpha);
+}
+
+glm::mat4 Hero::getRenderModelMatrix(glm::mat4 modelMtx, GLfloat alpha) const {
+    modelMtx = glm::translate( modelMtx, getRenderPos(alpha) );
+    modelMtx = glm::rotate( modelMtx, getRenderBodyAngle(alpha), glm::vec3(0.0f, 1.0f, 0.0f) );
+    return glm::scale( modelMtx, getRenderBodySize(alpha) );
+}
+
+void Hero::storePreviousState() {
+    _prevPos = _currPos;
+    _prevBodyAngle = _bodyAngle;
+    _prevScaleWholeBody = _scaleWholeBody;
 }
 
 bool Hero::getFalling() {
@@ -74,33 +79,31 @@ void Hero::setFalling(bool falling) {
 }
 
 // Implements our functions to turn our hero right and left.
-void Hero::turnRight() {
-    _bodyAngle -= _bodyAngleRotationFactor;
+void Hero::turnRight(GLfloat dt) {
+    _bodyAngle -= _bodyAngleRotationFactor * dt * FixedTimestep::REFERENCE_TICK_RATE;
 }
 
-void Hero::turnLeft() {
-    _bodyAngle += _bodyAngleRotationFactor;
+void Hero::turnLeft(GLfloat dt) {
+    _bodyAngle += _bodyAngleRotationFactor * dt * FixedTimestep::REFERENCE_TICK_RATE;
 }
 
-void Hero::moveForward() {
-    glm::vec3 nextPos = _currPos + glm::vec3(glm::cos(getBodyAngle()) / 10, 0.0, -glm::sin(getBodyAngle()) / 10);
-    if (nextPos.x < 214 && nextPos.x > -214 && nextPos.z < 214 && nextPos.z > -214) {
-        _currPos = nextPos;
-    }
+glm::vec3 Hero::getStep(GLfloat dt) const {
+    GLfloat step = dt * FixedTimestep::REFERENCE_TICK_RATE / 10;
+    return glm::vec3(glm::cos(getBodyAngle()) * step, 0.0, -glm::sin(getBodyAngle()) * step);
 }
 
-void Hero::moveBackward() {
-    glm::vec3 nextPos = _currPos - glm::vec3(glm::cos(getBodyAngle()) / 10, 0.0, -glm::sin(getBodyAngle()) / 10);
-    if (nextPos.x < 214 && nextPos.x > -214 && nextPos.z < 214 && nextPos.z > -214) {
-        _currPos = nextPos;
-    }
+void Hero::moveTo(glm::vec3 newPosition, GLfloat worldSize) {
+    newPosition.x = glm::clamp(newPosition.x, -worldSize, worldSize);
+    newPosition.z = glm::clamp(newPosition.z, -worldSize, worldSize);
+    _currPos = newPosition;
 }
 
-void Hero::idleMovement() {
+void Hero::idleMovement(GLfloat dt) {
     // Creates our idle movement of hovering up and down.
+    GLfloat ticks = dt * FixedTimestep::REFERENCE_TICK_RATE;
     _hoverAmount = _yOffset * std::sin(M_PI/180 * _timeVariable);
-    _currPos.y += _hoverAmount * 0.1f;
-    _timeVariable += 1;
+    _currPos.y += _hoverAmount * 0.1f * ticks;
+    _timeVariable += ticks;
     _currPos = glm::vec3(_currPos.x, _currPos.y, _currPos.z);
 }
 
@@ -108,13 +111,13 @@ void Hero::setHeroPosition(glm::vec3 newPosition) {
     _currPos = newPosition;
 }
 
-void Hero::setHeroWinner() {
+void Hero::setHeroWinner(GLfloat dt) {
 //    _colorHead = glm::vec3(1.0, 0.0, 0.0);
-    _scaleWholeBody *= 1.01f;
+    _scaleWholeBody *= glm::pow(1.01f, (GLfloat)(dt * FixedTimestep::REFERENCE_TICK_RATE));
 }
 
-void Hero::setHeroLoser() {
-    _scaleWholeBody *= 0.99f;
+void Hero::setHeroLoser(GLfloat dt) {
+    _scaleWholeBody *= glm::pow(0.99f, (GLfloat)(dt * FixedTimestep::REFERENCE_TICK_RATE));
 }
 
 const glm::vec3 &Hero::getBodySize() const {
@@ -130,82 +133,31 @@ void Hero::setHeroColor() {
     _colorBody = glm::vec3(1,0,0);
 }
 
-// Creates the function to correctly scale and draw our hero head using a sphere.
-void Hero::_drawHeroHead(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _transHead );
-    modelMtx1 = glm::scale( modelMtx1, _scaleHead );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorHead[0]);
-
-    CSCI441::drawSolidSphere( 0.8f, 10, 10);
+const glm::vec3 &Hero::getHeroColor() const {
+    return _colorBody;
 }
 
-// Creates the function to correctly scale and draw our hero eyes left and right using spheres.
-void Hero::_drawHeroLeftEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _transLeftEye );
-    modelMtx1 = glm::scale( modelMtx1, _scaleLeftEye );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
+// Adds every hero part to a mesh, each part keeps the transform it used to be drawn with.
+void Hero::addPartsToMesh(MeshBuilder& mesh, const LevelOfDetail::Level& level) const {
+    // body and legs using cubes
+    glm::mat4 bodyMtx = glm::scale( glm::translate( glm::mat4(1.0f), _transBody ), _scaleBody );
+    mesh.addCube( bodyMtx, 0.1f, _colorBody );
 
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorLeftEye[0]);
-
-    CSCI441::drawSolidSphere( 0.2f, 10, 10);
-}
+    glm::mat4 armMtx = glm::scale( glm::mat4(1.0f), _scaleArm );
+    mesh.addCube( armMtx, 0.17f, _colorArm );
 
-void Hero::_drawHeroRightEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _transRightEye );
-    modelMtx1 = glm::scale( modelMtx1, _scaleRightEye );
+    glm::mat4 legsMtx = glm::scale( glm::translate( glm::mat4(1.0f), _transLegs ), _scaleLegs );
+    mesh.addCube( legsMtx, 0.1f, _colorLegs );
 
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
+    // head and eyes using spheres, the eyes are too small to see at the coarsest levels
+    glm::mat4 headMtx = glm::scale( glm::translate( glm::mat4(1.0f), _transHead ), _scaleHead );
+    mesh.addSphere( headMtx, 0.8f, level.sphereStacks, level.sphereSlices, _colorHead );
 
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorRightEye[0]);
-
-    CSCI441::drawSolidSphere( 0.2f, 10, 10);
-}
-
-// Creates the function to correctly scale and draw our hero's body using a cube.
-void Hero::_drawHeroBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _transBody );
-    modelMtx1 = glm::scale( modelMtx1, _scaleBody );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorBody[0]);
-
-    CSCI441::drawSolidCube( 0.1f );
-}
-
-// Creates the function to correctly scale and draw our hero's legs using a cube.
-void Hero::_drawHeroLegs(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _transLegs );
-    modelMtx1 = glm::scale( modelMtx1, _scaleLegs );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorLegs[0]);
-
-    CSCI441::drawSolidCube( 0.1f );
-}
-
-// Creates the function to correctly scale and draw our hero's arms using a cube.
-void Hero::_drawHeroArm(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
-    modelMtx = glm::scale(modelMtx, _scaleArm );
-
-    _computeAndSendMatrixUniforms(modelMtx, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorArm[0]);
-
-    CSCI441::drawSolidCube( 0.17f );
-}
+    if( !level.includeDetails ) return;
 
-void Hero::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    // precompute the Model-View-Projection matrix on the CPU
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
-    // then send it to the shader on the GPU to apply to every vertex
-    glProgramUniformMatrix4fv( _shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, &mvpMtx[0][0] );
+    glm::mat4 leftEyeMtx = glm::scale( glm::translate( glm::mat4(1.0f), _transLeftEye ), _scaleLeftEye );
+    mesh.addSphere( leftEyeMtx, 0.2f, level.sphereStacks, level.sphereSlices, _colorLeftEye );
 
-    glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMtx )));
-    glProgramUniformMatrix3fv( _shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, &normalMtx[0][0] );
+    glm::mat4 rightEyeMtx = glm::scale( glm::translate( glm::mat4(1.0f), _transRightEye ), _scaleRightEye );
+    mesh.addSphere( rightEyeMtx, 0.2f, level.sphereStacks, level.sphereSlices, _colorRightEye );
 }
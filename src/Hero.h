@@ -1,64 +1,73 @@
 #ifndef LAB05_PLANE_H
 #define LAB05_PLANE_H
 
-#include <GL/glew.h>
+#include "GLTypes.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <vector>
 
+#include "FixedTimestep.h"
+#include "LevelOfDetail.h"
+
+class MeshBuilder;
+
 class Hero {
 public:
     /// \desc creates a simple hero
-    /// \param shaderProgramHandle shader program handle that the hero should be drawn using
-    /// \param mvpMtxUniformLocation uniform location for the full precomputed MVP matrix
-    /// \param normalMtxUniformLocation uniform location for the precomputed Normal matrix
-    /// \param materialColorUniformLocation uniform location for the material diffuse color
-    Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation );
-
-    /// \desc draws the model hero for a given MVP matrix
-    /// \param modelMtx existing model matrix to apply to hero
-    /// \param viewMtx camera view matrix to apply to hero
-    /// \param projMtx camera projection matrix to apply to hero
-    /// \note internally uses the provided shader program and sets the necessary uniforms
-    /// for the MVP and Normal Matrices as well as the material diffuse color
-    void drawHero( glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx );
-
-    glm::vec3 getCurrPos();
+    /// \note the hero holds no GL state, it is drawn by the HeroRenderer
+    Hero();
+
+    /// \desc appends every hero part to a mesh relative to the hero's root transform
+    /// using the part translations, scales and colors
+    /// \param mesh builder to add the body, arm, legs, head and eyes to
+    /// \param level tessellation to build the spheres with, the eyes are left out when it drops details
+    void addPartsToMesh( MeshBuilder& mesh, const LevelOfDetail::Level& level ) const;
+
+    glm::vec3 getCurrPos() const;
+    /// \desc position blended between the previous and current tick
+    [[nodiscard]] glm::vec3 getRenderPos(GLfloat alpha) const;
+    /// \desc heading blended between the previous and current tick
+    [[nodiscard]] GLfloat getRenderBodyAngle(GLfloat alpha) const;
+    /// \desc whole body scale blended between the previous and current tick
+    [[nodiscard]] glm::vec3 getRenderBodySize(GLfloat alpha) const;
+    /// \desc root transform of the hero as drawn, every baked part is placed relative to it
+    /// \param modelMtx existing model matrix to apply the root transform to
+    /// \param alpha how far between the previous and current tick to place the hero
+    [[nodiscard]] glm::mat4 getRenderModelMatrix(glm::mat4 modelMtx, GLfloat alpha) const;
+    /// \desc remembers the current state so rendering can blend from it once the next tick runs
+    void storePreviousState();
     // Creates function to get our angle for use of moving forward and backward with heading.
     GLfloat getBodyAngle() const { return _bodyAngle; }
 
     bool getFalling();
     void setFalling(bool falling);
 
-    // Initialize functions for turning right and left.
-    void turnRight();
-    void turnLeft();
-    void moveForward();
-    void moveBackward();
-    void idleMovement();
+    // Initialize functions for turning right and left.  dt is the length of the tick in seconds.
+    void turnRight(GLfloat dt);
+    void turnLeft(GLfloat dt);
+    /// \desc how far one tick of walking forward carries the hero along its heading
+    glm::vec3 getStep(GLfloat dt) const;
+    /// \desc moves the hero to a position, held on the edge of the world if it lies past it
+    /// \param worldSize half the size of the world along x and z
+    void moveTo(glm::vec3 newPosition, GLfloat worldSize);
+    void idleMovement(GLfloat dt);
     void setHeroPosition(glm::vec3 newPosition);
-    void setHeroWinner();
-    void setHeroLoser();
+    void setHeroWinner(GLfloat dt);
+    void setHeroLoser(GLfloat dt);
     [[nodiscard]] const glm::vec3 &getBodySize() const;
     void setHeroSize();
     void setHeroColor();
+    [[nodiscard]] const glm::vec3 &getHeroColor() const;
 
 private:
-    /// \desc handle of the shader program to use when drawing the hero
-    GLuint _shaderProgramHandle;
-    /// \desc stores the uniform locations needed for the plan information
-    struct ShaderProgramUniformLocations {
-        /// \desc location of the precomputed ModelViewProjection matrix
-        GLint mvpMtx;
-        /// \desc location of the precomputed Normal matrix
-        GLint normalMtx;
-        /// \desc location of the material diffuse color
-        GLint materialColor;
-    } _shaderProgramUniformLocations;
-
     glm::vec3 _currPos;
 
+    /// \desc state at the start of the current tick, blended towards when rendering
+    glm::vec3 _prevPos;
+    GLfloat _prevBodyAngle;
+    glm::vec3 _prevScaleWholeBody;
+
     bool _falling;
 
     // Variables used to create idle motion of hovering.
@@ -67,7 +76,6 @@ private:
     GLfloat _hoverAmount;
 
     // Initialize variables for drawing the hero.
-    glm::vec3 _transWholeBody;
     glm::vec3 _scaleWholeBody;
     GLfloat _bodyAngle;
     GLfloat _bodyAngleRotationFactor;
@@ -99,23 +107,7 @@ private:
     /// \desc amount to scale the hero's by
     glm::vec3 _scaleArm;
 
-    const GLfloat _PI = glm::pi<float>();
-
-    // Initialize functions used to draw hero parts.
-    void _drawHeroHead(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawHeroLeftEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawHeroRightEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawHeroBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawHeroLegs(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawHeroArm(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-
-    /// \desc precomputes the matrix uniforms CPU-side and then sends them
-    /// to the GPU to be used in the shader for each vertex.  It is more efficient
-    /// to calculate these once and then use the resultant product in the shader.
-    /// \param modelMtx model transformation matrix
-    /// \param viewMtx camera view matrix
-    /// \param projMtx camera projection matrix
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
+    GLfloat _PI = glm::pi<float>();
 };
 
 
@@ -0,0 +1,56 @@
+#include "HeroRenderer.h"
+
+#include "MeshBuilder.h"
+#include "MeshUploader.h"
+
+HeroRenderer::HeroRenderer(GLuint shaderProgramHandle, const Hero& hero, GLint vPosAttributeLocation, GLint vertexNormalAttributeLocation, GLint vertexColorAttributeLocation ) {
+    _shaderProgramHandle                            = shaderProgramHandle;
+    _shaderProgramAttributeLocations.vPos           = vPosAttributeLocation;
+    _shaderProgramAttributeLocations.vertexNormal   = vertexNormalAttributeLocation;
+    _shaderProgramAttributeLocations.vertexColor    = vertexColorAttributeLocation;
+
+    glGenVertexArrays(LevelOfDetail::NUM_LEVELS, _vaos);
+    glGenBuffers(2 * LevelOfDetail::NUM_LEVELS, _vbods);
+    _bakeMesh(hero);
+}
+
+HeroRenderer::~HeroRenderer() {
+    glDeleteBuffers(2 * LevelOfDetail::NUM_LEVELS, _vbods);
+    glDeleteVertexArrays(LevelOfDetail::NUM_LEVELS, _vaos);
+}
+
+// Main function to put together the hero and queue it as a whole.
+void HeroRenderer::submitHero(const Hero& hero, glm::mat4 modelMtx, FrustumCuller& culler, const LevelOfDetail& lod, RenderQueue& queue, GLfloat alpha ) {
+    // part colors live in the mesh, so a color change means baking again
+    if( hero.getHeroColor() != _bakedColor ) {
+        _bakeMesh(hero);
+    }
+
+    glm::vec3 scaleWholeBody = hero.getRenderBodySize(alpha);
+    modelMtx = hero.getRenderModelMatrix(modelMtx, alpha);
+
+    // bounding sphere of the baked mesh carried through the root transform
+    glm::vec3 center = glm::vec3( modelMtx * glm::vec4(_localBounds.getCenter(), 1.0f) );
+    GLfloat maxScale = glm::max( glm::abs(scaleWholeBody.x), glm::max( glm::abs(scaleWholeBody.y), glm::abs(scaleWholeBody.z) ) );
+    GLfloat radius = _localBounds.getBoundingRadius() * maxScale;
+    if( !culler.isSphereVisible(center, radius) ) return;
+
+    GLuint level = lod.selectLevel(center, radius);
+    if( level == LevelOfDetail::LEVEL_HIDDEN ) return;
+    // part colors live in the mesh, so the material color is left neutral
+    const glm::vec3 white(1.0f, 1.0f, 1.0f);
+    queue.submit( {_shaderProgramHandle, _vaos[level], GL_TRIANGLES, GL_UNSIGNED_INT, _numIndices[level], 0, 0, modelMtx, white} );
+}
+
+// Bakes every hero part into one mesh per level of detail.
+void HeroRenderer::_bakeMesh(const Hero& hero) {
+    for(GLuint levelIndex = 0; levelIndex < LevelOfDetail::NUM_LEVELS; levelIndex++) {
+        MeshBuilder mesh;
+        hero.addPartsToMesh(mesh, LevelOfDetail::getLevel(levelIndex));
+
+        // the finest level encloses every other level
+        if( levelIndex == 0 ) _localBounds = mesh.computeBounds();
+        _numIndices[levelIndex] = MeshUploader::upload(mesh, _vaos[levelIndex], _vbods[2 * levelIndex], _vbods[2 * levelIndex + 1], _shaderProgramAttributeLocations.vPos, _shaderProgramAttributeLocations.vertexNormal, _shaderProgramAttributeLocations.vertexColor);
+    }
+    _bakedColor = hero.getHeroColor();
+}
@@ -0,0 +1,63 @@
+#ifndef A5_HERO_RENDERER_H
+#define A5_HERO_RENDERER_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+#include "FrustumCuller.h"
+#include "Hero.h"
+#include "LevelOfDetail.h"
+#include "RenderQueue.h"
+
+class HeroRenderer {
+public:
+    /// \desc bakes the hero's parts into one mesh per level of detail
+    /// \param shaderProgramHandle shader program handle that the hero should be drawn using
+    /// \param hero hero whose parts make up the mesh
+    /// \param vPosAttributeLocation attribute location for the vertex position
+    /// \param vertexNormalAttributeLocation attribute location for the vertex normal
+    /// \param vertexColorAttributeLocation attribute location for the per-vertex color
+    HeroRenderer(GLuint shaderProgramHandle, const Hero& hero, GLint vPosAttributeLocation, GLint vertexNormalAttributeLocation, GLint vertexColorAttributeLocation );
+    ~HeroRenderer();
+
+    /// \desc queues the model hero for a given model matrix
+    /// \param hero hero to draw, the mesh is re-baked if its colors changed since the last bake
+    /// \param modelMtx existing model matrix to apply to hero
+    /// \param culler frustum for this frame, nothing is queued if the hero's bounding sphere is outside of it
+    /// \param lod picks which pre-baked tessellation to draw from the hero's size on screen
+    /// \param queue render queue the hero's draw packet is submitted to
+    /// \param alpha how far between the previous and current tick to draw the hero
+    /// \note every part is baked into one mesh with per-vertex colors, so a single packet
+    /// carrying the root Model Matrix is enough.  The view and projection come from the
+    /// per-frame uniform block
+    void submitHero( const Hero& hero, glm::mat4 modelMtx, FrustumCuller& culler, const LevelOfDetail& lod, RenderQueue& queue, GLfloat alpha );
+
+private:
+    /// \desc handle of the shader program to use when drawing the hero
+    GLuint _shaderProgramHandle;
+    /// \desc stores the attribute locations the baked mesh is hooked up to
+    struct ShaderProgramAttributeLocations {
+        GLint vPos;
+        GLint vertexNormal;
+        GLint vertexColor;
+    } _shaderProgramAttributeLocations;
+
+    /// \desc VAO for the baked hero mesh at each level of detail
+    GLuint _vaos[LevelOfDetail::NUM_LEVELS];
+    /// \desc 2 * level - VBO, 2 * level + 1 - IBO
+    GLuint _vbods[2 * LevelOfDetail::NUM_LEVELS];
+    /// \desc number of indices making up the baked hero mesh at each level of detail
+    GLsizei _numIndices[LevelOfDetail::NUM_LEVELS];
+    /// \desc bounds of the baked mesh before the root transform is applied
+    AABB _localBounds;
+    /// \desc body color the current mesh was baked with
+    glm::vec3 _bakedColor;
+
+    /// \desc merges every hero part into one mesh relative to the hero's root transform
+    /// then uploads it to the GPU once per level of detail
+    void _bakeMesh( const Hero& hero );
+};
+
+#endif //A5_HERO_RENDERER_H
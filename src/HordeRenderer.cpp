@@ -0,0 +1,84 @@
+#include "HordeRenderer.h"
+
+#include "MeshBuilder.h"
+#include "MeshUploader.h"
+
+#include <cstddef>
+
+HordeRenderer::HordeRenderer(GLuint shaderProgramHandle, const Enemy& prototype, GLint vPosLocation, GLint vertexNormalLocation, GLint vertexColorLocation, GLint instancePositionHeadingLocation, GLint instanceScaleLocation, GLint instanceColorLocation ) {
+    _shaderProgramHandle = shaderProgramHandle;
+
+    for(GLuint levelIndex = 0; levelIndex < LevelOfDetail::NUM_LEVELS; levelIndex++) {
+        Bucket& bucket = _buckets[levelIndex];
+
+        // every enemy shares the same parts, only the root transform and head color differ
+        MeshBuilder mesh;
+        prototype.addPartsToMesh(mesh, LevelOfDetail::getLevel(levelIndex));
+
+        if(levelIndex == 0) {
+            // centered on the origin rather than the box so the heading rotation can be ignored when culling
+            AABB bounds = mesh.computeBounds();
+            _localRadius = glm::length(bounds.getCenter()) + bounds.getBoundingRadius();
+        }
+
+        glGenVertexArrays(1, &bucket.vao);
+        glGenBuffers(3, bucket.vbos);
+        bucket.numIndices = MeshUploader::upload(mesh, bucket.vao, bucket.vbos[0], bucket.vbos[1], vPosLocation, vertexNormalLocation, vertexColorLocation);
+        bucket.instanceCapacity = 0;
+
+        // per-instance attributes advance once per enemy instead of once per vertex
+        glBindBuffer(GL_ARRAY_BUFFER, bucket.vbos[2]);
+        glEnableVertexAttribArray(instancePositionHeadingLocation);
+        glVertexAttribPointer(instancePositionHeadingLocation, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, positionHeading));
+        glVertexAttribDivisor(instancePositionHeadingLocation, 1);
+        glEnableVertexAttribArray(instanceScaleLocation);
+        glVertexAttribPointer(instanceScaleLocation, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, scale));
+        glVertexAttribDivisor(instanceScaleLocation, 1);
+        glEnableVertexAttribArray(instanceColorLocation);
+        glVertexAttribPointer(instanceColorLocation, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, color));
+        glVertexAttribDivisor(instanceColorLocation, 1);
+    }
+
+    glBindVertexArray(0);
+}
+
+HordeRenderer::~HordeRenderer() {
+    for(Bucket& bucket : _buckets) {
+        glDeleteBuffers(3, bucket.vbos);
+        glDeleteVertexArrays(1, &bucket.vao);
+    }
+}
+
+void HordeRenderer::submitHorde(const EnemyHorde& horde, FrustumCuller& culler, const LevelOfDetail& lod, RenderQueue& queue, GLfloat alpha) {
+    for(Bucket& bucket : _buckets) bucket.instances.clear();
+
+    for(GLuint i = 0; i < horde.getCount(); i++) {
+        if(horde.isDead(i)) continue;
+        glm::vec3 scale = horde.getBodySize(i);
+        GLfloat maxScale = glm::max( glm::abs(scale.x), glm::max( glm::abs(scale.y), glm::abs(scale.z) ) );
+        GLfloat radius = _localRadius * maxScale;
+        glm::vec3 position = horde.getRenderPos(i, alpha);
+        if(!culler.isSphereVisible(position, radius)) continue;
+
+        GLuint level = lod.selectLevel(position, radius);
+        if(level == LevelOfDetail::LEVEL_HIDDEN) continue;
+
+        _buckets[level].instances.push_back( {glm::vec4(position, horde.getRenderHeading(i, alpha)), scale, horde.getColor(i)} );
+    }
+
+    for(Bucket& bucket : _buckets) {
+        if(bucket.instances.empty()) continue;
+
+        glBindBuffer(GL_ARRAY_BUFFER, bucket.vbos[2]);
+        auto numInstances = (GLsizei)bucket.instances.size();
+        if(numInstances > bucket.instanceCapacity) {
+            // grow geometrically so a growing horde does not reallocate every frame
+            while(bucket.instanceCapacity < numInstances) bucket.instanceCapacity = bucket.instanceCapacity == 0 ? 64 : bucket.instanceCapacity * 2;
+        }
+        // orphan the previous frame's storage so the driver never waits on the GPU still reading it
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(bucket.instanceCapacity * sizeof(InstanceData)), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(numInstances * sizeof(InstanceData)), bucket.instances.data());
+
+        queue.submit( {_shaderProgramHandle, bucket.vao, GL_TRIANGLES, GL_UNSIGNED_INT, bucket.numIndices, 0, numInstances, glm::mat4(1.0f), glm::vec3(1.0f)} );
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef A5_HORDE_RENDERER_H
+#define A5_HORDE_RENDERER_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "AABB.h"
+#include "Enemy.h"
+#include "EnemyHorde.h"
+#include "FrustumCuller.h"
+#include "LevelOfDetail.h"
+#include "RenderQueue.h"
+
+class HordeRenderer {
+public:
+    /// \desc bakes the enemy mesh once per level of detail and creates the streaming per-instance buffers used to draw every enemy at once
+    /// \param shaderProgramHandle shader program handle that the horde should be drawn using
+    /// \param prototype enemy whose parts make up the shared mesh
+    /// \param vPosLocation attribute location for the vertex position
+    /// \param vertexNormalLocation attribute location for the vertex normal
+    /// \param vertexColorLocation attribute location for the per-vertex color
+    /// \param instancePositionHeadingLocation attribute location for the per-instance position and heading
+    /// \param instanceScaleLocation attribute location for the per-instance body scale
+    /// \param instanceColorLocation attribute location for the per-instance head color
+    HordeRenderer(GLuint shaderProgramHandle, const Enemy& prototype, GLint vPosLocation, GLint vertexNormalLocation, GLint vertexColorLocation, GLint instancePositionHeadingLocation, GLint instanceScaleLocation, GLint instanceColorLocation );
+    ~HordeRenderer();
+
+    /// \desc sorts every visible enemy into a bucket per level of detail and queues each bucket as a single instanced packet
+    /// \param horde enemies to draw, the dead ones are skipped
+    /// \param culler frustum for this frame, enemies outside of it never reach the instance buffers
+    /// \param lod picks the bucket from each enemy's size on screen, sub-pixel enemies are dropped
+    /// \param queue render queue the instanced packets are submitted to
+    /// \param alpha how far between the previous and current tick to draw the enemies
+    void submitHorde( const EnemyHorde& horde, FrustumCuller& culler, const LevelOfDetail& lod, RenderQueue& queue, GLfloat alpha );
+
+private:
+    /// \desc per-enemy data as laid out in the instance buffer
+    struct InstanceData {
+        /// \desc xyz is the world position, w is the heading about +y
+        glm::vec4 positionHeading;
+        glm::vec3 scale;
+        glm::vec3 color;
+    };
+
+    /// \desc mesh and instance stream for one level of detail
+    struct Bucket {
+        /// \desc VAO holding both the enemy mesh and the instance attributes
+        GLuint vao;
+        /// \desc 0 - mesh VBO, 1 - mesh IBO, 2 - instance VBO
+        GLuint vbos[3];
+        /// \desc number of indices making up the enemy mesh
+        GLsizei numIndices;
+        /// \desc number of instances the instance buffer can currently hold
+        GLsizei instanceCapacity;
+        /// \desc CPU staging area reused every frame to avoid reallocating
+        std::vector<InstanceData> instances;
+    };
+    Bucket _buckets[LevelOfDetail::NUM_LEVELS];
+
+    /// \desc handle of the shader program to use when drawing the horde
+    GLuint _shaderProgramHandle;
+
+    /// \desc radius about the enemy's origin enclosing the unscaled mesh at any heading
+    GLfloat _localRadius;
+};
+
+#endif //A5_HORDE_RENDERER_H
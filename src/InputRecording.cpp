@@ -0,0 +1,171 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+InputRecording::InputRecording() {
+    _tickRate = 0.0;
+    _numTicks = 0;
+    _hasFinalState = false;
+    _finalStateHash = 0;
+}
+
+void InputRecording::begin(const GameWorld::Config& worldConfig, GLdouble tickRate) {
+    _worldConfig = worldConfig;
+    _tickRate = tickRate;
+    _numTicks = 0;
+    _hasFinalState = false;
+    _finalStateHash = 0;
+    _changes.clear();
+}
+
+void InputRecording::record(const GameWorld::Input& input) {
+    GLubyte bits = input.toBits();
+    // held keys rarely change from one tick to the next, so only the changes are kept
+    if (_changes.empty() || _changes.back().bits != bits) {
+        _changes.push_back({_numTicks, bits});
+    }
+    _numTicks++;
+}
+
+void InputRecording::finish(const GameWorld& world) {
+    _hasFinalState = true;
+    _finalStateHash = _hashState(world);
+}
+
+bool InputRecording::matchesFinalState(const GameWorld& world) const {
+    return !_hasFinalState || _hashState(world) == _finalStateHash;
+}
+
+GLuint InputRecording::_hashState(const GameWorld& world) {
+    const glm::vec3 heroPos = world.getHero().getCurrPos();
+    // the position is hashed bit for bit, a replay that drifts by a single rounding step is still a mismatch
+    GLuint state[5];
+    state[0] = world.getTickCount();
+    memcpy(&state[1], &heroPos[0], 3 * sizeof(GLfloat));
+    state[4] = world.getVisitedTileCount();
+
+    // FNV-1a over the bytes of the fields
+    GLuint hash = 2166136261u;
+    const auto* pBytes = (const GLubyte*)state;
+    for (size_t i = 0; i < sizeof(state); i++) {
+        hash = (hash ^ pBytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+GameWorld::Input InputRecording::getInput(GLuint tick) const {
+    // the last change at or before the tick is still in effect
+    auto next = std::upper_bound(_changes.begin(), _changes.end(), tick,
+                                 [](GLuint t, const Change& change) { return t < change.tick; });
+    if (next == _changes.begin()) return GameWorld::Input::fromBits(0);
+    return GameWorld::Input::fromBits((next - 1)->bits);
+}
+
+// Layout, all values little endian as written by the host:
+//   magic[4] version:u32 simulationVersion:u32 seed:u32 numEnemies:u32 tileColumns:u32 tileRows:u32 numWalls:u32
+//   tickRate:f64 numTicks:u32 hasFinalState:u8 finalStateHash:u32 numChanges:u32
+//   numChanges x { tick:u32 bits:u8 }
+bool InputRecording::save(const char* filename) const {
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open \"%s\" to save the input recording\n", filename);
+        return false;
+    }
+
+    const GLuint version = FILE_VERSION;
+    const GLuint simulationVersion = GameWorld::SIMULATION_VERSION;
+    const auto numChanges = (GLuint)_changes.size();
+    fwrite(FILE_MAGIC, sizeof(FILE_MAGIC), 1, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(&simulationVersion, sizeof(simulationVersion), 1, file);
+    fwrite(&_worldConfig.seed, sizeof(GLuint), 1, file);
+    fwrite(&_worldConfig.numEnemies, sizeof(GLuint), 1, file);
+    fwrite(&_worldConfig.tileColumns, sizeof(GLuint), 1, file);
+    fwrite(&_worldConfig.tileRows, sizeof(GLuint), 1, file);
+    fwrite(&_worldConfig.numWalls, sizeof(GLuint), 1, file);
+    fwrite(&_tickRate, sizeof(_tickRate), 1, file);
+    fwrite(&_numTicks, sizeof(_numTicks), 1, file);
+    const GLubyte hasFinalState = _hasFinalState ? 1 : 0;
+    fwrite(&hasFinalState, sizeof(hasFinalState), 1, file);
+    fwrite(&_finalStateHash, sizeof(_finalStateHash), 1, file);
+    fwrite(&numChanges, sizeof(numChanges), 1, file);
+    // written field by field so the struct's padding never reaches the file
+    for (const Change& change : _changes) {
+        fwrite(&change.tick, sizeof(change.tick), 1, file);
+        fwrite(&change.bits, sizeof(change.bits), 1, file);
+    }
+
+    bool ok = !ferror(file);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "[ERROR]: Could not write the input recording to \"%s\"\n", filename);
+    }
+    return ok;
+}
+
+bool InputRecording::load(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open input recording \"%s\"\n", filename);
+        return false;
+    }
+
+    char magic[sizeof(FILE_MAGIC)];
+    GLuint version = 0, simulationVersion = 0, numChanges = 0;
+    GLubyte hasFinalState = 0;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1
+              && memcmp(magic, FILE_MAGIC, sizeof(magic)) == 0
+              && fread(&version, sizeof(version), 1, file) == 1
+              && version == FILE_VERSION
+              && fread(&simulationVersion, sizeof(simulationVersion), 1, file) == 1
+              && fread(&_worldConfig.seed, sizeof(GLuint), 1, file) == 1
+              && fread(&_worldConfig.numEnemies, sizeof(GLuint), 1, file) == 1
+              && fread(&_worldConfig.tileColumns, sizeof(GLuint), 1, file) == 1
+              && fread(&_worldConfig.tileRows, sizeof(GLuint), 1, file) == 1
+              && fread(&_worldConfig.numWalls, sizeof(GLuint), 1, file) == 1
+              && fread(&_tickRate, sizeof(_tickRate), 1, file) == 1
+              && fread(&_numTicks, sizeof(_numTicks), 1, file) == 1
+              && fread(&hasFinalState, sizeof(hasFinalState), 1, file) == 1
+              && fread(&_finalStateHash, sizeof(_finalStateHash), 1, file) == 1
+              && fread(&numChanges, sizeof(numChanges), 1, file) == 1
+              && _isValidHeader(numChanges);
+    _hasFinalState = hasFinalState != 0;
+
+    _changes.clear();
+    for (GLuint i = 0; ok && i < numChanges; i++) {
+        Change change = {0, 0};
+        ok = fread(&change.tick, sizeof(change.tick), 1, file) == 1
+             && fread(&change.bits, sizeof(change.bits), 1, file) == 1
+             // getInput searches the changes, so they must be in tick order
+             && change.tick < _numTicks
+             && (_changes.empty() || change.tick > _changes.back().tick);
+        _changes.push_back(change);
+    }
+    fclose(file);
+
+    if (ok && simulationVersion != GameWorld::SIMULATION_VERSION) {
+        // the controls would drive different rules than the ones they were recorded under
+        fprintf(stderr, "[ERROR]: \"%s\" was recorded with simulation version %u, this build runs version %u\n",
+                filename, simulationVersion, GameWorld::SIMULATION_VERSION);
+        begin(GameWorld::Config(), 0.0);
+        return false;
+    }
+    if (!ok) {
+        fprintf(stderr, "[ERROR]: \"%s\" is not a valid input recording\n", filename);
+        begin(GameWorld::Config(), 0.0);
+    }
+    return ok;
+}
+
+bool InputRecording::_isValidHeader(GLuint numChanges) const {
+    // the tick rate divides into the tick length, and every change is on a distinct tick
+    return std::isfinite(_tickRate) && _tickRate > 0.0
+           && _worldConfig.tileColumns > 0 && _worldConfig.tileRows > 0
+           && (GLdouble)_worldConfig.tileColumns * _worldConfig.tileRows <= MAX_TILES
+           && _worldConfig.numEnemies <= MAX_ENEMIES
+           && _worldConfig.numWalls <= MAX_WALLS
+           && numChanges <= _numTicks;
+}
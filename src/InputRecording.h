@@ -0,0 +1,81 @@
+#ifndef A5_INPUT_RECORDING_H
+#define A5_INPUT_RECORDING_H
+
+#include "GLTypes.h"
+
+#include <vector>
+
+#include "GameWorld.h"
+
+/// \desc the controls held on every tick of a session plus everything else needed to build an
+/// identical world, so the session can be replayed tick for tick through the headless core
+/// \note only the ticks where the held controls change are stored
+class InputRecording {
+public:
+    InputRecording();
+
+    /// \desc clears the recording and notes how the world it belongs to was created
+    /// \param worldConfig settings the world was built with, including the seed it used
+    /// \param tickRate simulation ticks per second the session ran at
+    void begin( const GameWorld::Config& worldConfig, GLdouble tickRate );
+
+    /// \desc appends the controls held during the next tick
+    void record( const GameWorld::Input& input );
+
+    /// \desc notes the state the world ended up in after the last recorded tick, so a replay can
+    /// tell whether it reached the same result
+    void finish( const GameWorld& world );
+
+    /// \desc controls held during a tick
+    /// \param tick index of the tick, must be below getNumTicks
+    [[nodiscard]] GameWorld::Input getInput( GLuint tick ) const;
+
+    /// \desc settings to build a world identical to the recorded one
+    [[nodiscard]] const GameWorld::Config& getWorldConfig() const { return _worldConfig; }
+    [[nodiscard]] GLdouble getTickRate() const { return _tickRate; }
+    /// \desc number of ticks recorded
+    [[nodiscard]] GLuint getNumTicks() const { return _numTicks; }
+    /// \desc true once finish has been called, recordings cut short have no final state
+    [[nodiscard]] bool hasFinalState() const { return _hasFinalState; }
+    /// \desc checks a world against the state noted by finish
+    /// \returns true if the world matches or no final state was noted
+    [[nodiscard]] bool matchesFinalState( const GameWorld& world ) const;
+
+    /// \desc writes the recording to a binary file
+    /// \returns false if the file could not be written
+    [[nodiscard]] bool save( const char* filename ) const;
+    /// \desc replaces the recording with one read from a binary file
+    /// \returns false if the file could not be read or is not a recording
+    [[nodiscard]] bool load( const char* filename );
+
+private:
+    /// \desc controls held from a tick onwards
+    struct Change {
+        GLuint tick;
+        GLubyte bits;
+    };
+
+    /// \desc identifies the file format, bump the version whenever the layout changes
+    static constexpr char FILE_MAGIC[4] = {'A', '5', 'I', 'R'};
+    static constexpr GLuint FILE_VERSION = 4;
+    /// \desc largest world a recording may ask for, well past any real session, so a damaged
+    /// header is rejected instead of building a world that exhausts memory
+    static constexpr GLuint MAX_ENEMIES = 1u << 16;
+    static constexpr GLuint MAX_TILES = 1u << 20;
+    static constexpr GLuint MAX_WALLS = 1u << 16;
+
+    /// \desc hashes the tick count, hero position and visited tile count of a world
+    [[nodiscard]] static GLuint _hashState( const GameWorld& world );
+    /// \desc checks the header fields read from a file describe a world that can be built
+    [[nodiscard]] bool _isValidHeader( GLuint numChanges ) const;
+
+    GameWorld::Config _worldConfig;
+    GLdouble _tickRate;
+    GLuint _numTicks;
+    bool _hasFinalState;
+    GLuint _finalStateHash;
+    /// \desc sorted by tick, the first entry is always tick 0
+    std::vector<Change> _changes;
+};
+
+#endif //A5_INPUT_RECORDING_H
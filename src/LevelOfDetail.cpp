@@ -0,0 +1,43 @@
+#include "LevelOfDetail.h"
+
+// level 1 matches the 10x10 spheres the characters were originally drawn with
+static const LevelOfDetail::Level LEVELS[LevelOfDetail::NUM_LEVELS] = {
+        { 16, 16, true,  60.0f },
+        { 10, 10, true,  15.0f },
+        {  6,  6, false,  1.0f }
+};
+
+const LevelOfDetail::Level& LevelOfDetail::getLevel(GLuint level) {
+    return LEVELS[level];
+}
+
+LevelOfDetail::LevelOfDetail() {
+    _viewportHeight = 1;
+    _viewMtx = glm::mat4(1.0f);
+    _pixelsPerUnit = 1.0f;
+}
+
+void LevelOfDetail::setViewportHeight(GLint viewportHeight) {
+    _viewportHeight = viewportHeight;
+}
+
+void LevelOfDetail::beginFrame(glm::mat4 viewMtx, glm::mat4 projMtx) {
+    _viewMtx = viewMtx;
+    // projMtx[1][1] is cot(fovy / 2), which maps a unit at depth one to half the viewport
+    _pixelsPerUnit = projMtx[1][1] * (GLfloat)_viewportHeight * 0.5f;
+}
+
+GLfloat LevelOfDetail::getScreenRadius(glm::vec3 center, GLfloat radius) const {
+    // the camera looks down -z in view space
+    GLfloat depth = -(_viewMtx * glm::vec4(center, 1.0f)).z;
+    if(depth <= radius) return (GLfloat)_viewportHeight;
+    return radius * _pixelsPerUnit / depth;
+}
+
+GLuint LevelOfDetail::selectLevel(glm::vec3 center, GLfloat radius) const {
+    GLfloat screenRadius = getScreenRadius(center, radius);
+    for(GLuint level = 0; level < NUM_LEVELS; level++) {
+        if(screenRadius >= LEVELS[level].minScreenRadius) return level;
+    }
+    return LEVEL_HIDDEN;
+}
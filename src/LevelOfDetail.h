@@ -0,0 +1,58 @@
+#ifndef A5_LEVEL_OF_DETAIL_H
+#define A5_LEVEL_OF_DETAIL_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+
+/// \desc picks how finely a character should be tessellated from how large it appears on screen
+class LevelOfDetail {
+public:
+    /// \desc number of pre-generated tessellations, level 0 is the finest
+    static constexpr GLuint NUM_LEVELS = 3;
+    /// \desc returned by selectLevel when the object covers less than a pixel and should not be drawn
+    static constexpr GLuint LEVEL_HIDDEN = NUM_LEVELS;
+
+    /// \desc how a single level is built
+    struct Level {
+        /// \desc rings from pole to pole used for every sphere part
+        GLint sphereStacks;
+        /// \desc segments around each ring used for every sphere part
+        GLint sphereSlices;
+        /// \desc whether small parts such as eyes are included, they are sub-pixel below this level
+        bool includeDetails;
+        /// \desc smallest projected radius in pixels this level is used for
+        GLfloat minScreenRadius;
+    };
+
+    /// \desc description of a level
+    /// \param level index below NUM_LEVELS
+    static const Level& getLevel( GLuint level );
+
+    LevelOfDetail();
+
+    /// \desc sets the height of the framebuffer in pixels, used to turn projected sizes into pixels
+    void setViewportHeight( GLint viewportHeight );
+
+    /// \desc stores the camera for this frame
+    /// \param viewMtx camera view matrix
+    /// \param projMtx camera projection matrix
+    void beginFrame( glm::mat4 viewMtx, glm::mat4 projMtx );
+
+    /// \desc projected radius in pixels of a bounding sphere
+    [[nodiscard]] GLfloat getScreenRadius( glm::vec3 center, GLfloat radius ) const;
+
+    /// \desc picks the level to draw a bounding sphere with
+    /// \returns level index or LEVEL_HIDDEN if the sphere is smaller than a pixel
+    [[nodiscard]] GLuint selectLevel( glm::vec3 center, GLfloat radius ) const;
+
+private:
+    /// \desc framebuffer height in pixels
+    GLint _viewportHeight;
+    /// \desc camera view matrix for this frame
+    glm::mat4 _viewMtx;
+    /// \desc pixels covered by one world unit at a view depth of one
+    GLfloat _pixelsPerUnit;
+};
+
+#endif //A5_LEVEL_OF_DETAIL_H
@@ -0,0 +1,73 @@
+#include "MeshBuilder.h"
+
+#include <glm/gtc/constants.hpp>
+
+void MeshBuilder::addCube(glm::mat4 modelMtx, GLfloat size, glm::vec3 color) {
+    // normals are baked with the inverse transpose so non-uniform scales keep them perpendicular
+    glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMtx )));
+
+    // four vertices per face so each face gets a flat normal
+    const glm::vec3 faceNormals[6] = {
+            { 1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            { 0.0f, 1.0f, 0.0f}, { 0.0f,-1.0f, 0.0f},
+            { 0.0f, 0.0f, 1.0f}, { 0.0f, 0.0f,-1.0f}
+    };
+    for(const glm::vec3& normal : faceNormals) {
+        // two axes spanning the face, ordered so the winding is counter-clockwise from outside
+        glm::vec3 u(normal.y, normal.z, normal.x);
+        glm::vec3 v = glm::cross(normal, u);
+        auto base = (GLuint)_vertices.size();
+        const GLfloat corners[4][2] = { {-1,-1}, {1,-1}, {1,1}, {-1,1} };
+        for(const auto& corner : corners) {
+            _addVertex(modelMtx, normalMtx, 0.5f * size * (normal + corner[0] * u + corner[1] * v), normal, color);
+        }
+        const GLuint faceIndices[6] = { 0, 1, 2, 0, 2, 3 };
+        for(GLuint index : faceIndices) _indices.push_back(base + index);
+    }
+}
+
+void MeshBuilder::addSphere(glm::mat4 modelMtx, GLfloat radius, GLint stacks, GLint slices, glm::vec3 color) {
+    glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMtx )));
+
+    // rings of (slices + 1) vertices from the top pole to the bottom pole, the seam is duplicated
+    auto base = (GLuint)_vertices.size();
+    for(GLint stack = 0; stack <= stacks; stack++) {
+        GLfloat phi = glm::pi<float>() * (GLfloat)stack / (GLfloat)stacks;
+        for(GLint slice = 0; slice <= slices; slice++) {
+            GLfloat theta = glm::two_pi<float>() * (GLfloat)slice / (GLfloat)slices;
+            glm::vec3 normal( glm::sin(phi) * glm::cos(theta), glm::cos(phi), glm::sin(phi) * glm::sin(theta) );
+            _addVertex(modelMtx, normalMtx, radius * normal, normal, color);
+        }
+    }
+
+    // two counter-clockwise triangles per quad between neighboring rings
+    const auto ringSize = (GLuint)(slices + 1);
+    for(GLint stack = 0; stack < stacks; stack++) {
+        for(GLint slice = 0; slice < slices; slice++) {
+            GLuint a = base + stack * ringSize + slice;
+            GLuint b = a + ringSize;
+            GLuint c = b + 1;
+            GLuint d = a + 1;
+            const GLuint quadIndices[6] = { a, c, b, a, d, c };
+            for(GLuint index : quadIndices) _indices.push_back(index);
+        }
+    }
+}
+
+AABB MeshBuilder::computeBounds() const {
+    if(_vertices.empty()) return { glm::vec3(0.0f), glm::vec3(0.0f) };
+
+    AABB bounds = { glm::vec3(_vertices[0].x, _vertices[0].y, _vertices[0].z), glm::vec3(_vertices[0].x, _vertices[0].y, _vertices[0].z) };
+    for(const Vertex& vertex : _vertices) {
+        glm::vec3 p(vertex.x, vertex.y, vertex.z);
+        bounds.minCorner = glm::min(bounds.minCorner, p);
+        bounds.maxCorner = glm::max(bounds.maxCorner, p);
+    }
+    return bounds;
+}
+
+void MeshBuilder::_addVertex(glm::mat4 modelMtx, glm::mat3 normalMtx, glm::vec3 position, glm::vec3 normal, glm::vec3 color) {
+    glm::vec3 p = glm::vec3( modelMtx * glm::vec4(position, 1.0f) );
+    glm::vec3 n = glm::normalize( normalMtx * normal );
+    _vertices.push_back( {p.x, p.y, p.z, n.x, n.y, n.z, color.x, color.y, color.z} );
+}
@@ -0,0 +1,50 @@
+#ifndef A5_MESH_BUILDER_H
+#define A5_MESH_BUILDER_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "AABB.h"
+
+/// \desc accumulates transformed primitives CPU-side so they can be uploaded as one static mesh
+/// by the MeshUploader
+class MeshBuilder {
+public:
+    /// \desc interleaved vertex layout of every mesh produced by the builder
+    struct Vertex {
+        GLfloat x, y, z;
+        GLfloat nx, ny, nz;
+        GLfloat r, g, b;
+    };
+
+    /// \desc appends a cube centered at the origin after transforming it by modelMtx
+    /// \param modelMtx transformation to bake into the cube's vertices
+    /// \param size length of each side of the cube before transforming
+    /// \param color color baked into every vertex of the cube
+    void addCube( glm::mat4 modelMtx, GLfloat size = 1.0f, glm::vec3 color = glm::vec3(1.0f) );
+
+    /// \desc appends a sphere centered at the origin after transforming it by modelMtx
+    /// \param modelMtx transformation to bake into the sphere's vertices
+    /// \param radius radius of the sphere before transforming
+    /// \param stacks number of rings from pole to pole
+    /// \param slices number of segments around each ring
+    /// \param color color baked into every vertex of the sphere
+    void addSphere( glm::mat4 modelMtx, GLfloat radius, GLint stacks, GLint slices, glm::vec3 color = glm::vec3(1.0f) );
+
+    /// \desc computes the box enclosing every vertex added so far
+    [[nodiscard]] AABB computeBounds() const;
+
+    [[nodiscard]] const std::vector<Vertex>& getVertices() const { return _vertices; }
+    [[nodiscard]] const std::vector<GLuint>& getIndices() const { return _indices; }
+
+private:
+    /// \desc appends a vertex after transforming its position and normal
+    void _addVertex( glm::mat4 modelMtx, glm::mat3 normalMtx, glm::vec3 position, glm::vec3 normal, glm::vec3 color );
+
+    std::vector<Vertex> _vertices;
+    std::vector<GLuint> _indices;
+};
+
+#endif //A5_MESH_BUILDER_H
@@ -0,0 +1,26 @@
+#include "MeshUploader.h"
+
+GLsizei MeshUploader::upload(const MeshBuilder& mesh, GLuint vao, GLuint vbo, GLuint ibo, GLint vPosLocation, GLint vertexNormalLocation, GLint vertexColorLocation) {
+    using Vertex = MeshBuilder::Vertex;
+    const std::vector<Vertex>& vertices = mesh.getVertices();
+    const std::vector<GLuint>& indices = mesh.getIndices();
+
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertices.size() * sizeof(Vertex)), vertices.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(vPosLocation);
+    glVertexAttribPointer(vPosLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)nullptr);
+    glEnableVertexAttribArray(vertexNormalLocation);
+    glVertexAttribPointer(vertexNormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(GLfloat)));
+    if(vertexColorLocation != -1) {
+        glEnableVertexAttribArray(vertexColorLocation);
+        glVertexAttribPointer(vertexColorLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(6 * sizeof(GLfloat)));
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(GLuint)), indices.data(), GL_STATIC_DRAW);
+
+    return (GLsizei)indices.size();
+}
@@ -0,0 +1,25 @@
+#ifndef A5_MESH_UPLOADER_H
+#define A5_MESH_UPLOADER_H
+
+#include <GL/glew.h>
+
+#include "MeshBuilder.h"
+
+/// \desc copies the geometry of a MeshBuilder into GL buffers, kept out of the builder so the
+/// game rules that build meshes never need a GL context
+class MeshUploader {
+public:
+    /// \desc uploads the accumulated geometry into the provided buffers and hooks
+    /// the position, normal and color attributes up to the provided VAO
+    /// \param mesh geometry to upload
+    /// \param vao vertex array object to record the attribute layout in
+    /// \param vbo buffer to store the vertices in
+    /// \param ibo buffer to store the indices in
+    /// \param vPosLocation attribute location for the vertex position
+    /// \param vertexNormalLocation attribute location for the vertex normal
+    /// \param vertexColorLocation attribute location for the vertex color, -1 if the shader does not use it
+    /// \returns number of indices uploaded
+    static GLsizei upload( const MeshBuilder& mesh, GLuint vao, GLuint vbo, GLuint ibo, GLint vPosLocation, GLint vertexNormalLocation, GLint vertexColorLocation = -1 );
+};
+
+#endif //A5_MESH_UPLOADER_H
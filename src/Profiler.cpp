@@ -0,0 +1,138 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+GLuint Profiler::registerZone(const char* name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (GLuint i = 0; i < _zones.size(); i++) {
+        if (strcmp(_zones[i].name, name) == 0) return i;
+    }
+    Zone zone = {name, 0, 0, 0.0, {}, 0};
+    zone.samples.reserve(WINDOW_SIZE);
+    _zones.push_back(zone);
+    return (GLuint)_zones.size() - 1;
+}
+
+const char* Profiler::getZoneName(GLuint zoneId) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return zoneId < _zones.size() ? _zones[zoneId].name : "unknown";
+}
+
+void Profiler::addSample(GLuint zoneId, GLdouble milliseconds) {
+    ThreadSamples& threadSamples = _getThreadSamples();
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(threadSamples.mutex);
+        threadSamples.samples.push_back({zoneId, milliseconds});
+        full = threadSamples.samples.size() >= MAX_BUFFERED_SAMPLES;
+    }
+    if (full) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _mergeThread(threadSamples);
+    }
+}
+
+void Profiler::addDroppedSample(GLuint zoneId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (zoneId < _zones.size()) _zones[zoneId].numDropped++;
+}
+
+Profiler::ThreadSamples& Profiler::_getThreadSamples() {
+    thread_local ThreadSamples threadSamples;
+    if (!threadSamples.registered) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        threadSamples.samples.reserve(MAX_BUFFERED_SAMPLES);
+        _threads.push_back(&threadSamples);
+        threadSamples.registered = true;
+    }
+    return threadSamples;
+}
+
+Profiler::ThreadSamples::~ThreadSamples() {
+    if (!registered) return;
+    // the thread's last samples are kept, then the profiler forgets the buffer before it goes away
+    Profiler& profiler = Profiler::instance();
+    std::lock_guard<std::mutex> lock(profiler._mutex);
+    profiler._mergeThread(*this);
+    profiler._threads.erase(std::find(profiler._threads.begin(), profiler._threads.end(), this));
+}
+
+void Profiler::_mergeAllThreads() const {
+    for (ThreadSamples* pThreadSamples : _threads) {
+        _mergeThread(*pThreadSamples);
+    }
+}
+
+void Profiler::_mergeThread(ThreadSamples& threadSamples) const {
+    // always taken after _mutex, so a reader and a thread merging its own full buffer cannot deadlock
+    std::lock_guard<std::mutex> lock(threadSamples.mutex);
+    for (const Sample& sample : threadSamples.samples) {
+        Zone& zone = _zones[sample.zoneId];
+        zone.totalCalls++;
+        zone.totalMs += sample.milliseconds;
+        if (zone.samples.size() < WINDOW_SIZE) {
+            zone.samples.push_back(sample.milliseconds);
+        } else {
+            zone.samples[zone.nextSample] = sample.milliseconds;
+        }
+        zone.nextSample = (zone.nextSample + 1) % WINDOW_SIZE;
+    }
+    threadSamples.samples.clear();
+}
+
+std::vector<Profiler::ZoneStats> Profiler::getStats() const {
+    std::vector<ZoneStats> stats;
+    std::vector<GLdouble> sorted;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _mergeAllThreads();
+    for (const Zone& zone : _zones) {
+        ZoneStats zoneStats = {zone.name, zone.totalCalls, (GLuint)zone.samples.size(), zone.numDropped, zone.totalMs, 0.0, 0.0, 0.0, 0.0};
+        if (!zone.samples.empty()) {
+            sorted = zone.samples;
+            std::sort(sorted.begin(), sorted.end());
+            GLdouble total = 0.0;
+            for (GLdouble sample : sorted) total += sample;
+            zoneStats.minMs = sorted.front();
+            zoneStats.maxMs = sorted.back();
+            zoneStats.avgMs = total / (GLdouble)sorted.size();
+            // nearest rank, so with few samples the p99 is simply the slowest one
+            auto rank = (size_t)((GLdouble)sorted.size() * 0.99);
+            zoneStats.p99Ms = sorted[std::min(rank, sorted.size() - 1)];
+        }
+        stats.push_back(zoneStats);
+    }
+    return stats;
+}
+
+void Profiler::printStats(FILE* stream) const {
+    fprintf(stream, "[INFO]: %-24s %8s %9s %9s %9s %9s\n", "zone", "calls", "min ms", "avg ms", "p99 ms", "max ms");
+    for (const ZoneStats& stats : getStats()) {
+        fprintf(stream, "[INFO]: %-24s %8u %9.3f %9.3f %9.3f %9.3f\n",
+                stats.name, stats.totalCalls, stats.minMs, stats.avgMs, stats.p99Ms, stats.maxMs);
+    }
+}
+
+bool Profiler::writeCsv(const char* filename) const {
+    FILE* file = fopen(filename, "w");
+    if (file == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open \"%s\" to write the profile\n", filename);
+        return false;
+    }
+
+    fprintf(file, "zone,total_calls,window_samples,dropped,total_ms,min_ms,avg_ms,p99_ms,max_ms\n");
+    for (const ZoneStats& stats : getStats()) {
+        fprintf(file, "%s,%u,%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                stats.name, stats.totalCalls, stats.numSamples, stats.numDropped, stats.totalMs, stats.minMs, stats.avgMs, stats.p99Ms, stats.maxMs);
+    }
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
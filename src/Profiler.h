@@ -0,0 +1,152 @@
+#ifndef A5_PROFILER_H
+#define A5_PROFILER_H
+
+#include "GLTypes.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "TraceRecorder.h"
+
+/// \desc collects how long named zones of code take and keeps rolling statistics over the most
+/// recent samples of each.  Zones may nest and may be timed from any thread, each thread buffers
+/// its own timings and they are folded into the statistics when those are read
+class Profiler {
+public:
+    /// \desc number of most recent samples the statistics of a zone are computed over
+    static constexpr GLuint WINDOW_SIZE = 300;
+
+    /// \desc statistics of one zone over its sample window, all times in milliseconds
+    struct ZoneStats {
+        const char* name;
+        /// \desc number of times the zone has been timed since the program started
+        GLuint totalCalls;
+        /// \desc number of samples the statistics below are taken over
+        GLuint numSamples;
+        /// \desc number of timings that were lost, such as GPU results not ready in time
+        GLuint numDropped;
+        /// \desc time spent in the zone since the program started, not limited to the window
+        GLdouble totalMs;
+        GLdouble minMs;
+        GLdouble avgMs;
+        GLdouble p99Ms;
+        GLdouble maxMs;
+    };
+
+    /// \desc the profiler shared by every thread
+    static Profiler& instance();
+
+    /// \desc finds or adds a zone
+    /// \param name name of the zone, must outlive the profiler such as a string literal
+    /// \returns id to pass to addSample
+    GLuint registerZone( const char* name );
+
+    /// \desc name a zone was registered with
+    [[nodiscard]] const char* getZoneName( GLuint zoneId ) const;
+
+    /// \desc adds one timing to a zone, held in the calling thread's buffer until the next read
+    void addSample( GLuint zoneId, GLdouble milliseconds );
+
+    /// \desc counts a timing of a zone that could not be taken.  Takes the profiler's lock, so it
+    /// is meant for rare events rather than every frame
+    void addDroppedSample( GLuint zoneId );
+
+    /// \desc statistics of every zone in registration order
+    [[nodiscard]] std::vector<ZoneStats> getStats() const;
+
+    /// \desc writes a table of every zone's statistics
+    void printStats( FILE* stream ) const;
+
+    /// \desc writes every zone's statistics as comma separated values
+    /// \returns false if the file could not be written
+    [[nodiscard]] bool writeCsv( const char* filename ) const;
+
+private:
+    Profiler() = default;
+
+    struct Zone {
+        const char* name;
+        GLuint totalCalls;
+        GLuint numDropped;
+        GLdouble totalMs;
+        /// \desc ring buffer of the last WINDOW_SIZE samples
+        std::vector<GLdouble> samples;
+        /// \desc position in samples the next sample is written to
+        GLuint nextSample;
+    };
+
+    /// \desc one timing waiting to be folded into its zone
+    struct Sample {
+        GLuint zoneId;
+        GLdouble milliseconds;
+    };
+
+    /// \desc timings a thread has taken since they were last merged.  Only the owning thread adds
+    /// to it, so its lock is only ever contended while the samples are being merged
+    struct ThreadSamples {
+        ~ThreadSamples();
+
+        std::mutex mutex;
+        std::vector<Sample> samples;
+        /// \desc true once the profiler knows of the buffer
+        bool registered = false;
+    };
+
+    /// \desc samples a thread buffers before merging them itself, so a thread whose zones are
+    /// never read does not grow without bound
+    static constexpr GLuint MAX_BUFFERED_SAMPLES = 4096;
+
+    /// \desc the calling thread's buffer, registered on first use and merged when the thread exits
+    ThreadSamples& _getThreadSamples();
+    /// \desc folds every thread's buffered samples into the zones, _mutex must be held
+    void _mergeAllThreads() const;
+    /// \desc folds one thread's buffered samples into the zones, _mutex must be held
+    void _mergeThread( ThreadSamples& threadSamples ) const;
+
+    /// \desc guards _zones and _threads, taken when zones are registered or read and when a
+    /// thread's buffer fills up, never for a single sample
+    mutable std::mutex _mutex;
+    /// \desc brought up to date from the thread buffers whenever the statistics are read
+    mutable std::vector<Zone> _zones;
+    /// \desc buffer of every thread that has timed a zone and not exited yet
+    std::vector<ThreadSamples*> _threads;
+};
+
+/// \desc times the enclosing block as one sample of a zone, and marks where it began and
+/// ended on the trace timeline
+class ProfileScope {
+public:
+    explicit ProfileScope( GLuint zoneId ) : _zoneId(zoneId), _start(std::chrono::steady_clock::now()) {
+        TraceRecorder::instance().beginZone(_zoneId, _start);
+    }
+    ~ProfileScope() {
+        auto end = std::chrono::steady_clock::now();
+        TraceRecorder::instance().endZone(_zoneId, end);
+        std::chrono::duration<GLdouble, std::milli> elapsed = end - _start;
+        Profiler::instance().addSample(_zoneId, elapsed.count());
+    }
+
+    ProfileScope( const ProfileScope& ) = delete;
+    ProfileScope& operator=( const ProfileScope& ) = delete;
+
+private:
+    GLuint _zoneId;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#define A5_PROFILE_CONCAT_INNER(a, b) a##b
+#define A5_PROFILE_CONCAT(a, b) A5_PROFILE_CONCAT_INNER(a, b)
+#ifdef A5_PROFILING
+/// \desc times the rest of the enclosing block under the given zone name, the zone is
+/// looked up once per call site
+#define A5_PROFILE_SCOPE(name) \
+    static const GLuint A5_PROFILE_CONCAT(_profileZone, __LINE__) = Profiler::instance().registerZone(name); \
+    ProfileScope A5_PROFILE_CONCAT(_profileScope, __LINE__)(A5_PROFILE_CONCAT(_profileZone, __LINE__))
+#else
+/// \desc profiling is compiled out, zones cost nothing and are neither timed nor traced
+#define A5_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif //A5_PROFILER_H
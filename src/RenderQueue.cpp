@@ -0,0 +1,130 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstdio>
+
+RenderQueue::RenderQueue() {
+    _viewMtx = glm::mat4(1.0f);
+    _packetCount = 0;
+    _drawCallCount = 0;
+}
+
+void RenderQueue::registerProgram(GLuint programHandle, GLint modelMtxLocation, GLint materialColorLocation) {
+    _programs.push_back( {programHandle, modelMtxLocation, materialColorLocation, glm::mat4(1.0f), glm::vec3(0.0f), false} );
+}
+
+void RenderQueue::beginFrame(glm::mat4 viewMtx) {
+    _viewMtx = viewMtx;
+    _packets.clear();
+    _packetPrograms.clear();
+}
+
+bool RenderQueue::submit(const DrawPacket& packet) {
+    // drawing with another program's bindings and sort slot would only hide the mistake
+    const GLint programIndex = _findProgram(packet.programHandle);
+    if(programIndex == NO_PROGRAM) {
+        fprintf(stderr, "[ERROR]: RenderQueue::submit(): program %u was never registered, packet dropped\n", packet.programHandle);
+        return false;
+    }
+    _packets.push_back(packet);
+    _packetPrograms.push_back((GLuint)programIndex);
+    return true;
+}
+
+void RenderQueue::flush() {
+    _sortedPackets.clear();
+    for(GLuint i = 0; i < _packets.size(); i++) {
+        _sortedPackets.emplace_back( _computeSortKey(_packets[i], _packetPrograms[i]), i );
+    }
+    std::sort(_sortedPackets.begin(), _sortedPackets.end());
+
+    _packetCount = (GLuint)_packets.size();
+    _drawCallCount = 0;
+
+    GLuint currentProgram = 0;
+    GLuint currentVAO = 0;
+    size_t i = 0;
+    while(i < _sortedPackets.size()) {
+        const DrawPacket& packet = _packets[_sortedPackets[i].second];
+        ProgramInfo& program = _programs[_packetPrograms[_sortedPackets[i].second]];
+
+        // state only changes when the key does, which sorting keeps to a minimum
+        if(packet.programHandle != currentProgram) {
+            glUseProgram(packet.programHandle);
+            currentProgram = packet.programHandle;
+        }
+        if(packet.vao != currentVAO) {
+            glBindVertexArray(packet.vao);
+            currentVAO = packet.vao;
+        }
+        if(program.modelMtxLocation != -1 && (!program.hasUniforms || program.lastModelMtx != packet.modelMtx)) {
+            glProgramUniformMatrix4fv(program.handle, program.modelMtxLocation, 1, GL_FALSE, &packet.modelMtx[0][0]);
+        }
+        if(program.materialColorLocation != -1 && (!program.hasUniforms || program.lastMaterialColor != packet.materialColor)) {
+            glProgramUniform3fv(program.handle, program.materialColorLocation, 1, &packet.materialColor[0]);
+        }
+        program.lastModelMtx = packet.modelMtx;
+        program.lastMaterialColor = packet.materialColor;
+        program.hasUniforms = true;
+
+        if(packet.instanceCount > 0) {
+            glDrawElementsInstanced(packet.mode, packet.indexCount, packet.indexType, (const void*)packet.indexOffset, packet.instanceCount);
+            i++;
+        } else {
+            // gather every following packet that only differs by its index range
+            _batchCounts.clear();
+            _batchOffsets.clear();
+            size_t end = i;
+            while(end < _sortedPackets.size() && _canMerge(packet, _packets[_sortedPackets[end].second])) {
+                const DrawPacket& merged = _packets[_sortedPackets[end].second];
+                _batchCounts.push_back(merged.indexCount);
+                _batchOffsets.push_back((const void*)merged.indexOffset);
+                end++;
+            }
+
+            if(_batchCounts.size() == 1) {
+                glDrawElements(packet.mode, packet.indexCount, packet.indexType, (const void*)packet.indexOffset);
+            } else {
+                glMultiDrawElements(packet.mode, _batchCounts.data(), packet.indexType, _batchOffsets.data(), (GLsizei)_batchCounts.size());
+            }
+            i = end;
+        }
+        _drawCallCount++;
+    }
+
+    _packets.clear();
+    _packetPrograms.clear();
+}
+
+uint64_t RenderQueue::_computeSortKey(const DrawPacket& packet, GLuint programIndex) const {
+    // material is the color quantized to 8 bits per channel
+    glm::vec3 color = glm::clamp(packet.materialColor, glm::vec3(0.0f), glm::vec3(1.0f));
+    auto material = ((uint64_t)(color.x * 255.0f) << 16) | ((uint64_t)(color.y * 255.0f) << 8) | (uint64_t)(color.z * 255.0f);
+
+    // the camera looks down -z in view space, nearer packets sort first so depth testing rejects more
+    GLfloat depth = -(_viewMtx * packet.modelMtx[3]).z;
+    depth = glm::clamp(depth / MAX_SORT_DEPTH, 0.0f, 1.0f);
+    auto depthBits = (uint64_t)(depth * (GLfloat)0xFFFFFF);
+
+    return ((uint64_t)(programIndex & 0xF) << 60)
+         | ((uint64_t)(packet.vao & 0xFFF) << 48)
+         | (material << 24)
+         | depthBits;
+}
+
+GLint RenderQueue::_findProgram(GLuint programHandle) const {
+    for(GLuint i = 0; i < _programs.size(); i++) {
+        if(_programs[i].handle == programHandle) return (GLint)i;
+    }
+    return NO_PROGRAM;
+}
+
+bool RenderQueue::_canMerge(const DrawPacket& first, const DrawPacket& second) {
+    return second.instanceCount == 0
+        && first.programHandle == second.programHandle
+        && first.vao == second.vao
+        && first.mode == second.mode
+        && first.indexType == second.indexType
+        && first.materialColor == second.materialColor
+        && first.modelMtx == second.modelMtx;
+}
@@ -0,0 +1,105 @@
+#ifndef A5_RENDER_QUEUE_H
+#define A5_RENDER_QUEUE_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/// \desc collects every draw for a frame, sorts them by a 64-bit state key and submits them
+/// with as few program, VAO and uniform changes as possible
+/// \note the queue does not instance draws by itself.  The model matrix is a uniform, so packets
+/// that share a mesh but not a transform stay separate draws, and a renderer that draws one mesh
+/// many times lays out its own instance attributes and submits a single instanced packet, as the
+/// TileRenderer and HordeRenderer do
+class RenderQueue {
+public:
+    /// \desc everything needed to issue one draw
+    struct DrawPacket {
+        /// \desc shader program to draw with, must have been registered
+        GLuint programHandle;
+        /// \desc VAO holding the mesh (and instance attributes if instanced)
+        GLuint vao;
+        /// \desc primitive type such as GL_TRIANGLES
+        GLenum mode;
+        /// \desc type of the indices, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+        GLenum indexType;
+        /// \desc number of indices to draw
+        GLsizei indexCount;
+        /// \desc byte offset of the first index into the VAO's index buffer
+        GLsizeiptr indexOffset;
+        /// \desc 0 for a plain draw, otherwise the number of instances already laid out in the VAO
+        GLsizei instanceCount;
+        /// \desc model matrix, ignored by programs without a model matrix uniform
+        glm::mat4 modelMtx;
+        /// \desc material diffuse color, ignored by programs without a material color uniform
+        glm::vec3 materialColor;
+    };
+
+    RenderQueue();
+
+    /// \desc makes a shader program available to packets, programs sort in registration order
+    /// \param programHandle handle of the shader program
+    /// \param modelMtxLocation uniform location of the model matrix, -1 if the program has none
+    /// \param materialColorLocation uniform location of the material color, -1 if the program has none
+    void registerProgram( GLuint programHandle, GLint modelMtxLocation, GLint materialColorLocation );
+
+    /// \desc clears the queue and stores the camera used to sort packets by depth
+    /// \param viewMtx camera view matrix for this frame
+    void beginFrame( glm::mat4 viewMtx );
+
+    /// \desc queues a packet to be drawn on the next flush
+    /// \returns false if the packet's program was never registered, the packet is dropped
+    bool submit( const DrawPacket& packet );
+
+    /// \desc sorts the queued packets and draws them.  Neighboring packets that share program, mesh,
+    /// material and transform are merged into a single glMultiDrawElements call
+    void flush();
+
+    /// \desc number of packets submitted on the last flush
+    [[nodiscard]] GLuint getPacketCount() const { return _packetCount; }
+    /// \desc number of draw calls the last flush issued
+    [[nodiscard]] GLuint getDrawCallCount() const { return _drawCallCount; }
+
+private:
+    /// \desc uniform locations of a registered program
+    struct ProgramInfo {
+        GLuint handle;
+        GLint modelMtxLocation;
+        GLint materialColorLocation;
+        /// \desc uniform values last sent to the program, so repeats are skipped
+        glm::mat4 lastModelMtx;
+        glm::vec3 lastMaterialColor;
+        bool hasUniforms;
+    };
+    std::vector<ProgramInfo> _programs;
+
+    /// \desc view space depth beyond which packets all sort as the farthest
+    static constexpr GLfloat MAX_SORT_DEPTH = 512.0f;
+
+    glm::mat4 _viewMtx;
+    std::vector<DrawPacket> _packets;
+    /// \desc position in _programs of each packet's program, parallel to _packets
+    std::vector<GLuint> _packetPrograms;
+    /// \desc sort key and packet index pairs, sorted instead of the packets themselves
+    std::vector<std::pair<uint64_t, GLuint>> _sortedPackets;
+
+    /// \desc index counts and offsets of the batch being merged
+    std::vector<GLsizei> _batchCounts;
+    std::vector<const void*> _batchOffsets;
+
+    GLuint _packetCount;
+    GLuint _drawCallCount;
+
+    /// \desc builds the key: 4 bits program, 12 bits VAO, 24 bits material, 24 bits front-to-back depth
+    [[nodiscard]] uint64_t _computeSortKey( const DrawPacket& packet, GLuint programIndex ) const;
+    /// \desc returned by _findProgram for a program that was never registered
+    static constexpr GLint NO_PROGRAM = -1;
+    /// \desc position of a program in _programs, or NO_PROGRAM
+    [[nodiscard]] GLint _findProgram( GLuint programHandle ) const;
+    /// \desc checks if two packets can be drawn by the same multi-draw call
+    [[nodiscard]] static bool _canMerge( const DrawPacket& first, const DrawPacket& second );
+};
+
+#endif //A5_RENDER_QUEUE_H
@@ -0,0 +1,122 @@
+#include "SimulationThread.h"
+#include "Profiler.h"
+
+#include <glm/glm.hpp>
+
+SimulationThread::SimulationThread(GameWorld& world)
+        : _world(world),
+          _running(false),
+          _inputState(0),
+          _pRecording(nullptr),
+          _numChangesPublished(0) {
+    _startTime = std::chrono::steady_clock::now();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (_thread.joinable()) return;
+
+    if (_pRecording != nullptr) {
+        _pRecording->begin(_world.getConfig(), 1.0 / _timestep.getTickLength());
+    }
+
+    // the render thread has something to draw before the first tick lands
+    _publishSnapshot(_now(), _inputState.load(std::memory_order_relaxed) >> INPUT_SEQUENCE_SHIFT);
+
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&SimulationThread::_run, this);
+}
+
+void SimulationThread::stop() {
+    _running.store(false, std::memory_order_release);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+GLuint SimulationThread::setInput(const GameWorld::Input& input) {
+    const GLuint bits = input.toBits();
+    const GLuint state = _inputState.load(std::memory_order_relaxed);
+    GLuint sequence = state >> INPUT_SEQUENCE_SHIFT;
+    // held controls are handed over every frame, only a change earns a new sequence number
+    if ((state & INPUT_BITS_MASK) != bits) {
+        sequence++;
+        _inputState.store((sequence << INPUT_SEQUENCE_SHIFT) | bits, std::memory_order_relaxed);
+    }
+    return sequence;
+}
+
+GLfloat SimulationThread::getAlpha(const WorldSnapshot& snapshot) const {
+    GLdouble alpha = (_now() - snapshot.tickTime) / _timestep.getTickLength();
+    return (GLfloat)glm::clamp(alpha, 0.0, 1.0);
+}
+
+GLdouble SimulationThread::_now() const {
+    return std::chrono::duration<GLdouble>(std::chrono::steady_clock::now() - _startTime).count();
+}
+
+void SimulationThread::_publishSnapshot(GLdouble tickTime, GLuint inputSequence) {
+    WorldSnapshot& snapshot = _snapshots.getWriteSlot();
+    snapshot.capture(_world, tickTime, inputSequence);
+    const auto numCaptured = (GLuint)snapshot.changedTiles.size();
+    if (_snapshots.publish()) {
+        // the render thread has applied the changes in the snapshot before this one, every later
+        // snapshot only needs what came after them
+        _world.forgetChangedTiles(_numChangesPublished);
+        _numChangesPublished = numCaptured - _numChangesPublished;
+    } else {
+        // the snapshot before this one was never drawn, this one carries its changes on
+        _numChangesPublished = numCaptured;
+    }
+}
+
+void SimulationThread::_run() {
+    TraceRecorder::instance().setThreadName("simulation");
+
+    const GLdouble tickLength = _timestep.getTickLength();
+    const auto dt = (GLfloat)tickLength;
+
+    GLdouble previousTime = _now();
+    while (_running.load(std::memory_order_acquire)) {
+        GLdouble currentTime = _now();
+        _timestep.advance(currentTime - previousTime);
+        previousTime = currentTime;
+
+        bool stepped = false;
+        GLuint inputSequence = 0;
+        while (_timestep.consumeTick()) {
+            A5_PROFILE_SCOPE("sim.tick");
+            // the controls are read once so the recording holds exactly what the world stepped with
+            const GLuint inputState = _inputState.load(std::memory_order_relaxed);
+            GameWorld::Input input = GameWorld::Input::fromBits((GLubyte)(inputState & INPUT_BITS_MASK));
+            inputSequence = inputState >> INPUT_SEQUENCE_SHIFT;
+            if (_pRecording != nullptr) {
+                _pRecording->record(input);
+            }
+            _world.step(input, dt);
+            stepped = true;
+        }
+
+        if (stepped) {
+            A5_PROFILE_SCOPE("sim.snapshot");
+            // the last tick was due this far back, rendering blends forward from there
+            GLdouble tickTime = currentTime - _timestep.getAlpha() * tickLength;
+            _publishSnapshot(tickTime, inputSequence);
+
+            // nothing changes once the game is over, the render thread closes the window
+            if (_world.isFinished()) break;
+        }
+
+        // sleep off whatever is left of the current tick
+        GLdouble remaining = (1.0 - _timestep.getAlpha()) * tickLength;
+        std::this_thread::sleep_for(std::chrono::duration<GLdouble>(remaining));
+    }
+
+    // every recorded tick has been stepped, so the world is in the state a replay should reach
+    if (_pRecording != nullptr) {
+        _pRecording->finish(_world);
+    }
+}
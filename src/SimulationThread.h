@@ -0,0 +1,86 @@
+#ifndef A5_SIMULATION_THREAD_H
+#define A5_SIMULATION_THREAD_H
+
+#include "GLTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "FixedTimestep.h"
+#include "GameWorld.h"
+#include "InputRecording.h"
+#include "SnapshotBuffer.h"
+#include "WorldSnapshot.h"
+
+/// \desc steps a GameWorld on its own thread at a fixed tick rate and publishes a snapshot after
+/// every batch of ticks, so a slow frame never stalls the game and a slow tick never stalls a frame
+class SimulationThread {
+public:
+    /// \param world world to step, the simulation thread owns it from start until stop
+    explicit SimulationThread( GameWorld& world );
+    /// \desc stops the thread if it is still running
+    ~SimulationThread();
+
+    /// \desc changes how many times per second the world is stepped, gameplay speed is unaffected
+    /// \note only call before start
+    void setTickRate( GLdouble ticksPerSecond ) { _timestep.setTickRate(ticksPerSecond); }
+
+    /// \desc logs the controls of every tick stepped from start onwards
+    /// \param pRecording recording to write to, nullptr stops recording
+    /// \note only call before start, the recording must not be read until stop
+    void setRecording( InputRecording* pRecording ) { _pRecording = pRecording; }
+
+    /// \desc publishes the starting state and begins stepping the world
+    void start();
+    /// \desc asks the thread to finish its current tick and waits for it
+    void stop();
+
+    /// \desc controls the next ticks should apply, call from one thread at a time
+    /// \returns sequence number of the controls, it grows every time they change and shows up in
+    /// WorldSnapshot::inputSequence once a tick has been stepped with them
+    GLuint setInput( const GameWorld::Input& input );
+
+    /// \desc newest snapshot published by the simulation thread, only the render thread may call this
+    /// \returns snapshot that stays unchanged until the next call
+    const WorldSnapshot& acquireSnapshot() { return _snapshots.acquireLatest(); }
+
+    /// \desc how far past a snapshot's tick the simulation clock is now
+    /// \returns blend factor in [0, 1] between the previous and current state held by the snapshot
+    [[nodiscard]] GLfloat getAlpha( const WorldSnapshot& snapshot ) const;
+
+private:
+    GameWorld& _world;
+    /// \desc hands the elapsed time out in fixed size ticks
+    FixedTimestep _timestep;
+    /// \desc snapshots passed from the simulation thread to the render thread
+    SnapshotBuffer _snapshots;
+
+    std::thread _thread;
+    /// \desc cleared to ask the simulation thread to exit
+    std::atomic<bool> _running;
+    /// \desc held controls packed by GameWorld::Input::toBits in the low byte and their sequence
+    /// number above it, written by the render thread and read every tick
+    std::atomic<GLuint> _inputState;
+    /// \desc bits of _inputState holding the controls
+    static constexpr GLuint INPUT_BITS_MASK = 0xFF;
+    /// \desc shift from _inputState to the sequence number
+    static constexpr GLuint INPUT_SEQUENCE_SHIFT = 8;
+    /// \desc where the controls of every tick are logged, nullptr when not recording
+    InputRecording* _pRecording;
+    /// \desc number of the world's changed tiles held by the last published snapshot
+    GLuint _numChangesPublished;
+
+    /// \desc simulation clock starts when the thread object is created
+    std::chrono::steady_clock::time_point _startTime;
+    /// \desc seconds on the simulation clock
+    [[nodiscard]] GLdouble _now() const;
+    /// \desc captures the world into the write slot and publishes it, then forgets the tile
+    /// changes the render thread is known to have taken
+    void _publishSnapshot( GLdouble tickTime, GLuint inputSequence );
+
+    /// \desc body of the simulation thread
+    void _run();
+};
+
+#endif //A5_SIMULATION_THREAD_H
@@ -0,0 +1,23 @@
+#include "SnapshotBuffer.h"
+
+SnapshotBuffer::SnapshotBuffer()
+        : _sharedIndex(1) {
+    _writeIndex = 0;
+    _readIndex = 2;
+}
+
+bool SnapshotBuffer::publish() {
+    // release makes the slot's contents visible before the reader can see the index
+    const GLuint previous = _sharedIndex.exchange(_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+    _writeIndex = previous & INDEX_MASK;
+    // the reader clears FRESH_BIT when it swaps the shared slot out
+    return (previous & FRESH_BIT) == 0;
+}
+
+const WorldSnapshot& SnapshotBuffer::acquireLatest() {
+    // only the writer sets FRESH_BIT, so if it is clear there is nothing newer to swap for
+    if (_sharedIndex.load(std::memory_order_relaxed) & FRESH_BIT) {
+        _readIndex = _sharedIndex.exchange(_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    return _slots[_readIndex];
+}
@@ -0,0 +1,42 @@
+#ifndef A5_SNAPSHOT_BUFFER_H
+#define A5_SNAPSHOT_BUFFER_H
+
+#include "GLTypes.h"
+
+#include <atomic>
+
+#include "WorldSnapshot.h"
+
+/// \desc lock-free triple buffer handing snapshots from one writer thread to one reader thread.
+/// The writer always has a slot to fill and the reader always has a complete slot to draw,
+/// the third slot sits between them holding the newest published snapshot
+class SnapshotBuffer {
+public:
+    SnapshotBuffer();
+
+    /// \desc slot the writer fills next, only the writer thread may touch it
+    WorldSnapshot& getWriteSlot() { return _slots[_writeIndex]; }
+    /// \desc hands the filled write slot over to the reader and takes back the spare slot
+    /// \returns true if the reader took the previously published snapshot before this one replaced it
+    bool publish();
+
+    /// \desc swaps in the newest published snapshot if there is one, only the reader thread may call this
+    /// \returns the newest snapshot, stays valid until the next call
+    const WorldSnapshot& acquireLatest();
+
+private:
+    static constexpr GLuint NUM_SLOTS = 3;
+    /// \desc set on the shared index when its slot holds a snapshot the reader has not seen
+    static constexpr GLuint FRESH_BIT = 0x4;
+    static constexpr GLuint INDEX_MASK = 0x3;
+
+    WorldSnapshot _slots[NUM_SLOTS];
+    /// \desc slot between the writer and the reader, plus FRESH_BIT
+    std::atomic<GLuint> _sharedIndex;
+    /// \desc slot owned by the writer
+    GLuint _writeIndex;
+    /// \desc slot owned by the reader
+    GLuint _readIndex;
+};
+
+#endif //A5_SNAPSHOT_BUFFER_H
@@ -0,0 +1,85 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(GLfloat cellSize) {
+    _cellSize = cellSize;
+    _bucketMask = 0;
+}
+
+GLint SpatialHash::_cellOf(GLfloat coordinate) const {
+    return (GLint)std::floor(coordinate / _cellSize);
+}
+
+GLuint SpatialHash::_bucketOf(GLint cellX, GLint cellZ) const {
+    // large primes spread neighboring cells over the table
+    return (((GLuint)cellX * 73856093u) ^ ((GLuint)cellZ * 19349663u)) & _bucketMask;
+}
+
+void SpatialHash::build(const glm::vec3* pPoints, const GLuint* pIds, GLuint numPoints) {
+    // at least twice as many buckets as points keeps the buckets short
+    GLuint numBuckets = 16;
+    while (numBuckets < numPoints * 2) numBuckets *= 2;
+    _bucketMask = numBuckets - 1;
+
+    // counting sort into buckets, so a rebuild never allocates once the sizes settle
+    _bucketStart.assign(numBuckets + 1, 0);
+    _unsorted.resize(numPoints);
+    for (GLuint i = 0; i < numPoints; i++) {
+        Entry entry = {pIds[i], _cellOf(pPoints[i].x), _cellOf(pPoints[i].z)};
+        _unsorted[i] = entry;
+        _bucketStart[_bucketOf(entry.cellX, entry.cellZ) + 1]++;
+    }
+    for (GLuint b = 0; b < numBuckets; b++) {
+        _bucketStart[b + 1] += _bucketStart[b];
+    }
+    _entries.resize(numPoints);
+    for (const Entry& entry : _unsorted) {
+        // _bucketStart[b] walks forward as bucket b fills and ends up where bucket b + 1 starts,
+        // shifting the starts back by one afterwards restores them
+        _entries[_bucketStart[_bucketOf(entry.cellX, entry.cellZ)]++] = entry;
+    }
+    for (GLuint b = numBuckets; b > 0; b--) {
+        _bucketStart[b] = _bucketStart[b - 1];
+    }
+    _bucketStart[0] = 0;
+}
+
+void SpatialHash::query(glm::vec3 position, std::vector<GLuint>& ids) const {
+    ids.clear();
+    if (_entries.empty()) return;
+
+    const GLint cellX = _cellOf(position.x);
+    const GLint cellZ = _cellOf(position.z);
+    for (GLint x = cellX - 1; x <= cellX + 1; x++) {
+        for (GLint z = cellZ - 1; z <= cellZ + 1; z++) {
+            const GLuint bucket = _bucketOf(x, z);
+            for (GLuint e = _bucketStart[bucket]; e < _bucketStart[bucket + 1]; e++) {
+                // other cells can share the bucket, they are not neighbors
+                if (_entries[e].cellX == x && _entries[e].cellZ == z) {
+                    ids.push_back(_entries[e].id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::findPairs(std::vector<Pair>& pairs) const {
+    pairs.clear();
+    for (const Entry& entry : _entries) {
+        for (GLint x = entry.cellX - 1; x <= entry.cellX + 1; x++) {
+            for (GLint z = entry.cellZ - 1; z <= entry.cellZ + 1; z++) {
+                const GLuint bucket = _bucketOf(x, z);
+                for (GLuint e = _bucketStart[bucket]; e < _bucketStart[bucket + 1]; e++) {
+                    const Entry& other = _entries[e];
+                    // each pair is reported once, from the side of its smaller id
+                    if (other.id > entry.id && other.cellX == x && other.cellZ == z) {
+                        pairs.emplace_back(entry.id, other.id);
+                    }
+                }
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+}
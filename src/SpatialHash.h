@@ -0,0 +1,60 @@
+#ifndef A5_SPATIAL_HASH_H
+#define A5_SPATIAL_HASH_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+/// \desc buckets points by the square cell of the world grid they fall in, looking down the y
+/// axis, so the points near a position are found without testing every other point.  Rebuilt
+/// from scratch whenever the points move, which takes time linear in their number
+class SpatialHash {
+public:
+    /// \desc two ids found near each other, the first is always the smaller
+    using Pair = std::pair<GLuint, GLuint>;
+
+    /// \param cellSize width of a grid cell, any two points closer than this along both axes
+    /// are reported as neighbors
+    explicit SpatialHash( GLfloat cellSize );
+
+    /// \desc replaces the contents with a new set of points
+    /// \param pPoints positions, only x and z are used
+    /// \param pIds id reported for each point, ids must be unique
+    /// \param numPoints number of points
+    void build( const glm::vec3* pPoints, const GLuint* pIds, GLuint numPoints );
+
+    /// \desc finds the points in the cell of a position and the eight cells around it
+    /// \param position where to look
+    /// \param ids cleared and filled with the ids found, in no particular order
+    void query( glm::vec3 position, std::vector<GLuint>& ids ) const;
+
+    /// \desc finds every pair of points in the same or neighboring cells
+    /// \param pairs cleared and filled with the pairs, sorted by first id and then by second
+    void findPairs( std::vector<Pair>& pairs ) const;
+
+private:
+    struct Entry {
+        GLuint id;
+        GLint cellX;
+        GLint cellZ;
+    };
+
+    /// \desc grid cell a position falls in along one axis
+    [[nodiscard]] GLint _cellOf( GLfloat coordinate ) const;
+    /// \desc bucket of the table a grid cell is stored in
+    [[nodiscard]] GLuint _bucketOf( GLint cellX, GLint cellZ ) const;
+
+    GLfloat _cellSize;
+    /// \desc number of buckets minus one, the table size is always a power of two
+    GLuint _bucketMask;
+    /// \desc entries of bucket b are _entries[_bucketStart[b]] up to _entries[_bucketStart[b + 1]]
+    std::vector<GLuint> _bucketStart;
+    /// \desc every point, grouped by bucket
+    std::vector<Entry> _entries;
+    /// \desc scratch copy of the points in input order while they are sorted into buckets
+    std::vector<Entry> _unsorted;
+};
+
+#endif //A5_SPATIAL_HASH_H
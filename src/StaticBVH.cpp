@@ -0,0 +1,181 @@
+#include "StaticBVH.h"
+
+#include <algorithm>
+#include <bitset>
+#include <limits>
+
+StaticBVH::StaticBVH() = default;
+
+void StaticBVH::build(const std::vector<AABB>& boxes) {
+    _nodes.clear();
+    _boxes.clear();
+    _colliders = ColliderSet();
+    _boxIds.resize(boxes.size());
+    for (GLuint i = 0; i < boxes.size(); i++) {
+        _boxIds[i] = i;
+    }
+    if (boxes.empty()) return;
+
+    // halving the boxes at every level makes a little under two nodes per group
+    _nodes.reserve(2 * (boxes.size() / ColliderSet::LANE_WIDTH + 1));
+    _buildNode(boxes, 0, (GLuint)boxes.size());
+
+    // the leaves split the boxes on group boundaries, so adding them in order lines each leaf up with a group
+    for (GLuint id : _boxIds) {
+        _boxes.push_back(boxes[id]);
+        _colliders.add(boxes[id]);
+    }
+}
+
+GLuint StaticBVH::_buildNode(const std::vector<AABB>& boxes, GLuint first, GLuint count) {
+    const auto index = (GLuint)_nodes.size();
+    _nodes.emplace_back();
+
+    AABB bounds = boxes[_boxIds[first]];
+    glm::vec3 centerMin = bounds.getCenter();
+    glm::vec3 centerMax = centerMin;
+    for (GLuint i = first + 1; i < first + count; i++) {
+        const AABB& box = boxes[_boxIds[i]];
+        bounds.minCorner = glm::min(bounds.minCorner, box.minCorner);
+        bounds.maxCorner = glm::max(bounds.maxCorner, box.maxCorner);
+        centerMin = glm::min(centerMin, box.getCenter());
+        centerMax = glm::max(centerMax, box.getCenter());
+    }
+    _nodes[index].bounds = bounds;
+
+    if (count <= ColliderSet::LANE_WIDTH) {
+        _nodes[index].firstBox = first;
+        _nodes[index].numBoxes = count;
+        _nodes[index].secondChild = 0;
+        return index;
+    }
+
+    // split across the axis the centers spread furthest along, with the first half rounded up to
+    // whole groups so only the very last leaf can be short of boxes
+    const glm::vec3 spread = centerMax - centerMin;
+    GLuint axis = 0;
+    if (spread.y > spread[axis]) axis = 1;
+    if (spread.z > spread[axis]) axis = 2;
+    const GLuint half = (count / 2 + ColliderSet::LANE_WIDTH - 1) / ColliderSet::LANE_WIDTH * ColliderSet::LANE_WIDTH;
+    std::nth_element(_boxIds.begin() + first, _boxIds.begin() + first + half, _boxIds.begin() + first + count,
+                     [&boxes, axis](GLuint a, GLuint b) {
+                         return boxes[a].getCenter()[axis] < boxes[b].getCenter()[axis];
+                     });
+
+    _nodes[index].firstBox = 0;
+    _nodes[index].numBoxes = 0;
+    _buildNode(boxes, first, half);
+    const GLuint secondChild = _buildNode(boxes, first + half, count - half);
+    _nodes[index].secondChild = secondChild;
+    return index;
+}
+
+void StaticBVH::countContainingXZ(const glm::vec3* pPoints, GLuint numPoints, GLuint* pCounts) const {
+    for (GLuint p = 0; p < numPoints; p++) {
+        const glm::vec3 point = pPoints[p];
+        GLuint count = 0;
+        _walk([point](const AABB& bounds) { return bounds.containsXZ(point); },
+              [this, point, &count](const Node& leaf) {
+                  count += (GLuint)std::bitset<ColliderSet::LANE_WIDTH>(_colliders.containMaskXZ(leaf.firstBox, point)).count();
+              });
+        pCounts[p] = count;
+    }
+}
+
+void StaticBVH::findOverlappingXZ(const AABB* pRegions, GLuint numRegions, std::vector<GLuint>& boxes, std::vector<GLuint>& firstBoxes) const {
+    boxes.clear();
+    firstBoxes.resize(numRegions + 1);
+    for (GLuint r = 0; r < numRegions; r++) {
+        const AABB& region = pRegions[r];
+        firstBoxes[r] = (GLuint)boxes.size();
+        _walk([&region](const AABB& bounds) { return bounds.overlapsXZ(region); },
+              [this, &region, &boxes](const Node& leaf) {
+                  const GLuint mask = _colliders.overlapMaskXZ(leaf.firstBox, region.minCorner, region.maxCorner);
+                  for (GLuint lane = 0; lane < leaf.numBoxes; lane++) {
+                      if (mask & (1u << lane)) boxes.push_back(_boxIds[leaf.firstBox + lane]);
+                  }
+              });
+    }
+    firstBoxes[numRegions] = (GLuint)boxes.size();
+}
+
+void StaticBVH::raycast(const Ray* pRays, GLuint numRays, RayHit* pHits) const {
+    for (GLuint r = 0; r < numRays; r++) {
+        pHits[r] = _castRay(pRays[r], false);
+    }
+}
+
+void StaticBVH::testLineOfSight(const glm::vec3* pFrom, const glm::vec3* pTo, GLuint numLines, bool* pVisible) const {
+    for (GLuint l = 0; l < numLines; l++) {
+        const glm::vec3 line = pTo[l] - pFrom[l];
+        const GLfloat length = glm::length(line);
+        if (length == 0.0f) {
+            pVisible[l] = true;
+            continue;
+        }
+        const Ray ray = {pFrom[l], line / length, length};
+        pVisible[l] = _castRay(ray, true).box == NO_BOX;
+    }
+}
+
+bool StaticBVH::_rayEntersBox(const AABB& box, const Ray& ray, glm::vec3 inverseDirection, GLfloat& distance) {
+    // the slabs are entered at the larger of the near distances and left at the smaller of the far
+    const glm::vec3 toMin = (box.minCorner - ray.origin) * inverseDirection;
+    const glm::vec3 toMax = (box.maxCorner - ray.origin) * inverseDirection;
+    const glm::vec3 slabEnter = glm::min(toMin, toMax);
+    const glm::vec3 slabExit = glm::max(toMin, toMax);
+    const GLfloat enter = glm::max(glm::max(slabEnter.x, slabEnter.y), slabEnter.z);
+    const GLfloat exit = glm::min(glm::min(slabExit.x, slabExit.y), slabExit.z);
+    if (enter > exit || exit < 0.0f || enter > ray.maxDistance) return false;
+    distance = glm::max(enter, 0.0f);
+    return true;
+}
+
+StaticBVH::RayHit StaticBVH::_castRay(const Ray& ray, bool stopAtFirst) const {
+    // a ray running parallel to a slab gets a huge inverse instead of infinity, so a start exactly
+    // on the slab's face multiplies out to zero rather than not a number
+    glm::vec3 inverseDirection;
+    for (GLuint a = 0; a < 3; a++) {
+        inverseDirection[a] = ray.direction[a] != 0.0f ? 1.0f / ray.direction[a] : std::numeric_limits<GLfloat>::max();
+    }
+
+    RayHit hit = {NO_BOX, ray.maxDistance};
+    _walk([this, &ray, inverseDirection, &hit, stopAtFirst](const AABB& bounds) {
+              if (stopAtFirst && hit.box != NO_BOX) return false;
+              // anything starting past the nearest hit so far cannot be nearer
+              GLfloat distance;
+              return _rayEntersBox(bounds, ray, inverseDirection, distance) && distance <= hit.distance;
+          },
+          [this, &ray, inverseDirection, &hit](const Node& leaf) {
+              for (GLuint b = leaf.firstBox; b < leaf.firstBox + leaf.numBoxes; b++) {
+                  GLfloat distance;
+                  if (_rayEntersBox(_boxes[b], ray, inverseDirection, distance)
+                      && (hit.box == NO_BOX || distance < hit.distance)) {
+                      hit.box = (GLint)_boxIds[b];
+                      hit.distance = distance;
+                  }
+              }
+          });
+    return hit;
+}
+
+glm::vec3 StaticBVH::sweepXZ(glm::vec3 start, glm::vec3 displacement) const {
+    // sliding only ever gives up part of the movement along an axis, so the whole path stays
+    // inside the box spanned by the start and the unobstructed end
+    const glm::vec3 end = start + displacement;
+    const AABB path = {glm::min(start, end), glm::max(start, end)};
+
+    GLuint groups[MAX_SWEEP_GROUPS];
+    GLuint numGroups = 0;
+    bool overflowed = false;
+    _walk([&path, &overflowed](const AABB& bounds) { return !overflowed && bounds.overlapsXZ(path); },
+          [&groups, &numGroups, &overflowed](const Node& leaf) {
+              if (numGroups == MAX_SWEEP_GROUPS) {
+                  overflowed = true;
+              } else {
+                  groups[numGroups++] = leaf.firstBox;
+              }
+          });
+    if (overflowed) return _colliders.sweepXZ(start, displacement);
+    return _colliders.sweepXZ(start, displacement, groups, numGroups);
+}
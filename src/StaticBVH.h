@@ -0,0 +1,148 @@
+#ifndef A5_STATIC_BVH_H
+#define A5_STATIC_BVH_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "AABB.h"
+#include "ColliderSet.h"
+
+/// \desc bounding volume hierarchy over boxes that never move, built once when a level is loaded.
+/// Every leaf is one group of the ColliderSet the boxes are stored in, so the boxes in a leaf are
+/// still tested together, while whole branches of the level are skipped with a single test
+class StaticBVH {
+public:
+    /// \desc box index reported by a ray that hit nothing
+    static constexpr GLint NO_BOX = -1;
+
+    /// \desc half line starting at a point
+    struct Ray {
+        /// \desc where the ray starts
+        glm::vec3 origin;
+        /// \desc unit length direction the ray travels in
+        glm::vec3 direction;
+        /// \desc boxes further along the ray than this are not hit
+        GLfloat maxDistance;
+    };
+
+    /// \desc where a ray first met a box
+    struct RayHit {
+        /// \desc index of the box as it was passed to build, or NO_BOX
+        GLint box;
+        /// \desc distance along the ray to the hit, zero if the ray starts inside the box
+        GLfloat distance;
+    };
+
+    StaticBVH();
+
+    /// \desc replaces the hierarchy with one over a new set of boxes
+    /// \param boxes boxes to store, queries report them by their index in this list
+    void build( const std::vector<AABB>& boxes );
+
+    /// \desc number of boxes in the hierarchy
+    [[nodiscard]] GLuint getBoxCount() const { return (GLuint)_boxIds.size(); }
+
+    /// \desc number of nodes, inner and leaf, in the hierarchy
+    [[nodiscard]] GLuint getNodeCount() const { return (GLuint)_nodes.size(); }
+
+    /// \desc counts the boxes each of a batch of points lies strictly inside of when looking down
+    /// the y axis, same test as AABB::containsXZ
+    /// \param pPoints points to test
+    /// \param numPoints number of points
+    /// \param pCounts receives one count per point
+    void countContainingXZ( const glm::vec3* pPoints, GLuint numPoints, GLuint* pCounts ) const;
+
+    /// \desc finds the boxes each of a batch of regions shares some area with when looking down the
+    /// y axis, same test as AABB::overlapsXZ
+    /// \param pRegions regions to test
+    /// \param numRegions number of regions
+    /// \param boxes receives the indices of the boxes found, region by region in no particular order
+    /// \param firstBoxes receives numRegions + 1 entries, the boxes found for region i are
+    /// boxes[firstBoxes[i]] up to but not including boxes[firstBoxes[i + 1]]
+    void findOverlappingXZ( const AABB* pRegions, GLuint numRegions, std::vector<GLuint>& boxes, std::vector<GLuint>& firstBoxes ) const;
+
+    /// \desc finds the nearest box each of a batch of rays hits
+    /// \param pRays rays to cast
+    /// \param numRays number of rays
+    /// \param pHits receives one hit per ray
+    void raycast( const Ray* pRays, GLuint numRays, RayHit* pHits ) const;
+
+    /// \desc checks whether the straight line between each pair of points is clear of every box,
+    /// stopping at the first box found instead of searching for the nearest
+    /// \param pFrom where each line starts
+    /// \param pTo where each line ends
+    /// \param numLines number of lines
+    /// \param pVisible receives true for each line that no box blocks
+    void testLineOfSight( const glm::vec3* pFrom, const glm::vec3* pTo, GLuint numLines, bool* pVisible ) const;
+
+    /// \desc ColliderSet::sweepXZ against only the boxes near the path
+    [[nodiscard]] glm::vec3 sweepXZ( glm::vec3 start, glm::vec3 displacement ) const;
+
+private:
+    /// \desc entry in the hierarchy, the first child of an inner node directly follows it
+    struct Node {
+        /// \desc encloses every box below the node
+        AABB bounds;
+        /// \desc index of the second child, for inner nodes
+        GLuint secondChild;
+        /// \desc first box of the leaf's group in _colliders, for leaves
+        GLuint firstBox;
+        /// \desc number of boxes in the leaf, zero for inner nodes
+        GLuint numBoxes;
+    };
+
+    /// \desc nodes waiting to be visited while walking the hierarchy, the build keeps it balanced
+    /// so this is far more than its depth can ever reach
+    static constexpr GLuint MAX_STACK = 64;
+    /// \desc most groups a single sweep gathers, a sweep near more falls back to testing every box
+    static constexpr GLuint MAX_SWEEP_GROUPS = 32;
+
+    /// \desc builds the nodes over part of _boxIds, reordering it so each leaf is one group
+    /// \returns index of the node built
+    GLuint _buildNode( const std::vector<AABB>& boxes, GLuint first, GLuint count );
+
+    /// \desc casts one ray
+    /// \param stopAtFirst report the first box found rather than the nearest
+    [[nodiscard]] RayHit _castRay( const Ray& ray, bool stopAtFirst ) const;
+
+    /// \desc slab test of a ray against a box
+    /// \param inverseDirection one over each component of the ray's direction
+    /// \param distance receives how far along the ray it enters the box
+    /// \returns true if the ray meets the box before maxDistance
+    [[nodiscard]] static bool _rayEntersBox( const AABB& box, const Ray& ray, glm::vec3 inverseDirection, GLfloat& distance );
+
+    /// \desc walks the hierarchy depth first
+    /// \param enterNode called with a node's bounds, returns false to skip everything below it
+    /// \param visitLeaf called with each leaf whose bounds were entered
+    template<typename EnterNode, typename VisitLeaf>
+    void _walk( EnterNode enterNode, VisitLeaf visitLeaf ) const {
+        if (_nodes.empty()) return;
+        GLuint stack[MAX_STACK];
+        GLuint stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const GLuint index = stack[--stackSize];
+            const Node& node = _nodes[index];
+            if (!enterNode(node.bounds)) continue;
+            if (node.numBoxes > 0) {
+                visitLeaf(node);
+            } else {
+                // the first child goes on top so the tree is walked in storage order
+                stack[stackSize++] = node.secondChild;
+                stack[stackSize++] = index + 1;
+            }
+        }
+    }
+
+    std::vector<Node> _nodes;
+    /// \desc the boxes in leaf order, every leaf starts a new group
+    ColliderSet _colliders;
+    /// \desc the boxes in leaf order with their heights, for rays
+    std::vector<AABB> _boxes;
+    /// \desc index passed to build of each box in leaf order
+    std::vector<GLuint> _boxIds;
+};
+
+#endif //A5_STATIC_BVH_H
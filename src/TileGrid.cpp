@@ -0,0 +1,34 @@
+#include "TileGrid.h"
+
+#include <cmath>
+
+TileGrid::TileGrid(GLuint columns, GLuint rows) {
+    _columns = columns;
+    _rows = rows;
+    // centered on the origin, so the first center sits half the grid's span from it
+    _firstCenter = glm::vec3(-(GLfloat)((GLint)columns - 1) * TILE_SPACING / 2.0f,
+                             0.0f,
+                             -(GLfloat)((GLint)rows - 1) * TILE_SPACING / 2.0f);
+}
+
+glm::vec3 TileGrid::getCenter(GLuint column, GLuint row) const {
+    return _firstCenter + glm::vec3((GLfloat)column * TILE_SPACING, 0.0f, (GLfloat)row * TILE_SPACING);
+}
+
+GLint TileGrid::_nearestLine(GLfloat coordinate, GLfloat firstCenter) {
+    return (GLint)std::floor((coordinate - firstCenter) / TILE_SPACING + 0.5f);
+}
+
+GLint TileGrid::findTile(glm::vec3 position) const {
+    // tiles are narrower than their spacing, so only the nearest one can hold the position
+    const GLint column = _nearestLine(position.x, _firstCenter.x);
+    const GLint row = _nearestLine(position.z, _firstCenter.z);
+    if (column < 0 || column >= (GLint)_columns || row < 0 || row >= (GLint)_rows) return NO_TILE;
+
+    const glm::vec3 center = getCenter((GLuint)column, (GLuint)row);
+    if (position.x > center.x - TILE_HALF_SIZE && position.x < center.x + TILE_HALF_SIZE
+        && position.z > center.z - TILE_HALF_SIZE && position.z < center.z + TILE_HALF_SIZE) {
+        return (GLint)getIndex((GLuint)column, (GLuint)row);
+    }
+    return NO_TILE;
+}
@@ -0,0 +1,47 @@
+#ifndef A5_TILE_GRID_H
+#define A5_TILE_GRID_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+
+/// \desc layout of the floor tiles: a regular grid centered on the origin, stored column by
+/// column.  Finds the tile under a position arithmetically instead of testing every tile
+class TileGrid {
+public:
+    /// \desc distance between the centers of neighboring tiles
+    static constexpr GLfloat TILE_SPACING = 18.0f;
+    /// \desc half the width of a tile, the gap between neighbors is bare ground
+    static constexpr GLfloat TILE_HALF_SIZE = 4.5f;
+    /// \desc returned by findTile for a position that is not on any tile
+    static constexpr GLint NO_TILE = -1;
+
+    /// \param columns tiles along x
+    /// \param rows tiles along z
+    TileGrid( GLuint columns, GLuint rows );
+
+    [[nodiscard]] GLuint getColumns() const { return _columns; }
+    [[nodiscard]] GLuint getRows() const { return _rows; }
+    [[nodiscard]] GLuint getTileCount() const { return _columns * _rows; }
+
+    /// \desc position of a tile in the densely packed tile storage
+    [[nodiscard]] GLuint getIndex( GLuint column, GLuint row ) const { return column * _rows + row; }
+
+    /// \desc world space center of a tile
+    [[nodiscard]] glm::vec3 getCenter( GLuint column, GLuint row ) const;
+
+    /// \desc finds the tile a position lies strictly inside of when looking down the y axis
+    /// \returns index of the tile, or NO_TILE
+    [[nodiscard]] GLint findTile( glm::vec3 position ) const;
+
+private:
+    GLuint _columns;
+    GLuint _rows;
+    /// \desc world space center of the tile in column 0, row 0
+    glm::vec3 _firstCenter;
+
+    /// \desc nearest column or row to a coordinate, may lie outside the grid
+    [[nodiscard]] static GLint _nearestLine( GLfloat coordinate, GLfloat firstCenter );
+};
+
+#endif //A5_TILE_GRID_H
@@ -0,0 +1,100 @@
+#include "TileRenderer.h"
+
+#include "MeshBuilder.h"
+#include "MeshUploader.h"
+
+#include <cstddef>
+
+TileRenderer::TileRenderer(GLuint shaderProgramHandle, GLint vPosLocation, GLint vertexNormalLocation, GLint instanceModelMtxLocation, GLint instanceNormalMtxLocation, GLint instanceColorLocation ) {
+    _shaderProgramHandle = shaderProgramHandle;
+
+    // a single unit cube is shared by every tile, the instance data places and colors it
+    MeshBuilder cube;
+    cube.addCube( glm::mat4(1.0f) );
+
+    glGenVertexArrays(2, _vaos);
+    glGenBuffers(4, _vbos);
+    _numIndices = MeshUploader::upload(cube, _vaos[0], _vbos[0], _vbos[1], vPosLocation, vertexNormalLocation);
+
+    _setupVAO(_vaos[0], _vbos[2], vPosLocation, vertexNormalLocation, instanceModelMtxLocation, instanceNormalMtxLocation, instanceColorLocation);
+    _setupVAO(_vaos[1], _vbos[3], vPosLocation, vertexNormalLocation, instanceModelMtxLocation, instanceNormalMtxLocation, instanceColorLocation);
+
+    glBindVertexArray(0);
+}
+
+TileRenderer::~TileRenderer() {
+    glDeleteBuffers(4, _vbos);
+    glDeleteVertexArrays(2, _vaos);
+}
+
+void TileRenderer::setTiles(const std::vector<glm::mat4>& modelMatrices, const std::vector<glm::vec3>& colors) {
+    _instances.clear();
+    _bounds.clear();
+    for(size_t i = 0; i < modelMatrices.size(); i++) {
+        // the tiles never move, so the normal matrix is computed once here rather than every frame
+        glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMatrices[i] )));
+        _instances.push_back( {modelMatrices[i], normalMtx, colors[i]} );
+
+        // bounds of the unit cube after it is placed
+        MeshBuilder tile;
+        tile.addCube( modelMatrices[i] );
+        _bounds.push_back( tile.computeBounds() );
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbos[2]);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(_instances.size() * sizeof(InstanceData)), _instances.data(), GL_STATIC_DRAW);
+}
+
+void TileRenderer::setTileColor(GLuint tileIndex, glm::vec3 color) {
+    _instances[tileIndex].color = color;
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbos[2]);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(tileIndex * sizeof(InstanceData) + offsetof(InstanceData, color)), sizeof(glm::vec3), &color[0]);
+}
+
+void TileRenderer::submitTiles(FrustumCuller& culler, RenderQueue& queue) {
+    _visibleInstances.clear();
+    for(size_t i = 0; i < _instances.size(); i++) {
+        if(culler.isBoxVisible(_bounds[i])) {
+            _visibleInstances.push_back(_instances[i]);
+        }
+    }
+    if(_visibleInstances.empty()) return;
+
+    GLuint vao = _vaos[0];
+    if(_visibleInstances.size() != _instances.size()) {
+        // something was culled, so the static buffer no longer holds exactly what to draw
+        glBindBuffer(GL_ARRAY_BUFFER, _vbos[3]);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(_visibleInstances.size() * sizeof(InstanceData)), _visibleInstances.data(), GL_STREAM_DRAW);
+        vao = _vaos[1];
+    }
+    queue.submit( {_shaderProgramHandle, vao, GL_TRIANGLES, GL_UNSIGNED_INT, _numIndices, 0, (GLsizei)_visibleInstances.size(), glm::mat4(1.0f), glm::vec3(1.0f)} );
+}
+
+void TileRenderer::_setupVAO(GLuint vao, GLuint instanceVBO, GLint vPosLocation, GLint vertexNormalLocation, GLint instanceModelMtxLocation, GLint instanceNormalMtxLocation, GLint instanceColorLocation) const {
+    glBindVertexArray(vao);
+
+    // both VAOs share the cube mesh
+    glBindBuffer(GL_ARRAY_BUFFER, _vbos[0]);
+    glEnableVertexAttribArray(vPosLocation);
+    glVertexAttribPointer(vPosLocation, 3, GL_FLOAT, GL_FALSE, sizeof(MeshBuilder::Vertex), (void*)nullptr);
+    glEnableVertexAttribArray(vertexNormalLocation);
+    glVertexAttribPointer(vertexNormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(MeshBuilder::Vertex), (void*)(3 * sizeof(GLfloat)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vbos[1]);
+
+    // per-instance attributes advance once per tile instead of once per vertex
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for(GLint column = 0; column < 4; column++) {
+        glEnableVertexAttribArray(instanceModelMtxLocation + column);
+        glVertexAttribPointer(instanceModelMtxLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offsetof(InstanceData, modelMtx) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(instanceModelMtxLocation + column, 1);
+    }
+    for(GLint column = 0; column < 3; column++) {
+        glEnableVertexAttribArray(instanceNormalMtxLocation + column);
+        glVertexAttribPointer(instanceNormalMtxLocation + column, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offsetof(InstanceData, normalMtx) + column * sizeof(glm::vec3)));
+        glVertexAttribDivisor(instanceNormalMtxLocation + column, 1);
+    }
+    glEnableVertexAttribArray(instanceColorLocation);
+    glVertexAttribPointer(instanceColorLocation, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, color));
+    glVertexAttribDivisor(instanceColorLocation, 1);
+}
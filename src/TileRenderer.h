@@ -0,0 +1,69 @@
+#ifndef A5_TILE_RENDERER_H
+#define A5_TILE_RENDERER_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "AABB.h"
+#include "FrustumCuller.h"
+#include "RenderQueue.h"
+
+class TileRenderer {
+public:
+    /// \desc creates the shared cube mesh and the per-instance buffer used to draw every tile at once
+    /// \param shaderProgramHandle shader program handle that the tiles should be drawn using
+    /// \param vPosLocation attribute location for the vertex position
+    /// \param vertexNormalLocation attribute location for the vertex normal
+    /// \param instanceModelMtxLocation first attribute location of the per-instance model matrix (uses 4 slots)
+    /// \param instanceNormalMtxLocation first attribute location of the per-instance normal matrix (uses 3 slots)
+    /// \param instanceColorLocation attribute location for the per-instance material color
+    TileRenderer(GLuint shaderProgramHandle, GLint vPosLocation, GLint vertexNormalLocation, GLint instanceModelMtxLocation, GLint instanceNormalMtxLocation, GLint instanceColorLocation );
+    ~TileRenderer();
+
+    /// \desc uploads the transforms and colors of every tile to the GPU
+    /// \param modelMatrices model matrix for each tile
+    /// \param colors material color for each tile, parallel to modelMatrices
+    void setTiles( const std::vector<glm::mat4>& modelMatrices, const std::vector<glm::vec3>& colors );
+
+    /// \desc patches the color of a single tile in place without touching the rest of the buffer
+    /// \param tileIndex index of the tile as passed to setTiles
+    /// \param color new material color for the tile
+    void setTileColor( GLuint tileIndex, glm::vec3 color );
+
+    /// \desc queues every visible tile as a single instanced draw packet
+    /// \param culler frustum for this frame, tiles outside of it are skipped
+    /// \param queue render queue the instanced packet is submitted to
+    /// \note when every tile is visible the static instance buffer is drawn directly,
+    /// otherwise the visible tiles are streamed to a second buffer first
+    void submitTiles( FrustumCuller& culler, RenderQueue& queue );
+
+private:
+    /// \desc per-tile data as laid out in the instance buffer
+    struct InstanceData {
+        glm::mat4 modelMtx;
+        glm::mat3 normalMtx;
+        glm::vec3 color;
+    };
+
+    /// \desc handle of the shader program to use when drawing the tiles
+    GLuint _shaderProgramHandle;
+    /// \desc 0 - draws from the static instance buffer, 1 - draws from the visible instance stream
+    GLuint _vaos[2];
+    /// \desc 0 - cube VBO, 1 - cube IBO, 2 - static instance VBO, 3 - visible instance stream VBO
+    GLuint _vbos[4];
+    /// \desc number of indices making up the cube
+    GLsizei _numIndices;
+    /// \desc CPU copy of the static instance buffer used to gather visible tiles
+    std::vector<InstanceData> _instances;
+    /// \desc world space bounds of each tile, parallel to _instances
+    std::vector<AABB> _bounds;
+    /// \desc visible tiles gathered this frame
+    std::vector<InstanceData> _visibleInstances;
+
+    /// \desc hooks the cube mesh and the per-instance attributes of instanceVBO up to vao
+    void _setupVAO( GLuint vao, GLuint instanceVBO, GLint vPosLocation, GLint vertexNormalLocation, GLint instanceModelMtxLocation, GLint instanceNormalMtxLocation, GLint instanceColorLocation ) const;
+};
+
+#endif //A5_TILE_RENDERER_H
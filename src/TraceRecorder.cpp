@@ -0,0 +1,154 @@
+#include "TraceRecorder.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder() {
+    _startTime = std::chrono::steady_clock::now();
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char* name) {
+    GLuint threadId = _getThreadId();
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& threadName : _threadNames) {
+        if (threadName.first == threadId) {
+            threadName.second = name;
+            return;
+        }
+    }
+    _threadNames.emplace_back(threadId, name);
+}
+
+void TraceRecorder::beginZone(GLuint zoneId, std::chrono::steady_clock::time_point time) {
+    _addEvent(zoneId, Phase::BEGIN, time);
+}
+
+void TraceRecorder::endZone(GLuint zoneId, std::chrono::steady_clock::time_point time) {
+    _addEvent(zoneId, Phase::END, time);
+}
+
+void TraceRecorder::markFrame(GLuint frameNumber) {
+    _addEvent(frameNumber, Phase::FRAME, std::chrono::steady_clock::now());
+}
+
+bool TraceRecorder::writeJson(const char* filename) const {
+    // the events are copied out in order so the threads adding more never wait on the file
+    std::vector<Event> events;
+    std::vector<std::pair<GLuint, const char*>> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        events = _exitedEvents;
+        for (ThreadEvents* pThreadEvents : _threads) {
+            std::lock_guard<std::mutex> threadLock(pThreadEvents->mutex);
+            pThreadEvents->copyInOrder(events);
+        }
+        threadNames = _threadNames;
+    }
+    // each thread's events are already in time order, a stable sort interleaves the threads
+    // without reordering events that share a timestamp
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.timestampUs < b.timestampUs; });
+
+    FILE* file = fopen(filename, "w");
+    if (file == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open \"%s\" to write the trace\n", filename);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& threadName : threadNames) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", threadName.first, threadName.second);
+        first = false;
+    }
+
+    // zones open on each thread, an end with none open lost its begin when the ring wrapped
+    std::vector<GLuint> openZones;
+    for (const Event& event : events) {
+        if (event.phase != Phase::FRAME) {
+            if (event.threadId >= openZones.size()) openZones.resize(event.threadId + 1, 0);
+            if (event.phase == Phase::BEGIN) {
+                openZones[event.threadId]++;
+            } else if (openZones[event.threadId] == 0) {
+                continue;
+            } else {
+                openZones[event.threadId]--;
+            }
+        }
+
+        const char* separator = first ? "" : ",\n";
+        first = false;
+        if (event.phase == Phase::FRAME) {
+            fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"frame\":%u}}",
+                    separator, event.threadId, event.timestampUs, event.id);
+        } else {
+            const char* name = Profiler::instance().getZoneName(event.id);
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                    separator, name, event.phase == Phase::BEGIN ? 'B' : 'E', event.threadId, event.timestampUs);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+GLuint TraceRecorder::_getThreadId() {
+    static std::atomic<GLuint> nextThreadId(1);
+    thread_local GLuint threadId = nextThreadId.fetch_add(1);
+    return threadId;
+}
+
+TraceRecorder::ThreadEvents& TraceRecorder::_getThreadEvents() {
+    thread_local ThreadEvents threadEvents;
+    if (!threadEvents.registered) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        threadEvents.events.resize(CAPACITY);
+        _threads.push_back(&threadEvents);
+        threadEvents.registered = true;
+    }
+    return threadEvents;
+}
+
+TraceRecorder::ThreadEvents::~ThreadEvents() {
+    if (!registered) return;
+    // the thread's last events stay in the trace, then the recorder forgets the buffer before it goes away
+    TraceRecorder& recorder = TraceRecorder::instance();
+    std::lock_guard<std::mutex> lock(recorder._mutex);
+    {
+        std::lock_guard<std::mutex> threadLock(mutex);
+        copyInOrder(recorder._exitedEvents);
+    }
+    if (recorder._exitedEvents.size() > CAPACITY) {
+        recorder._exitedEvents.erase(recorder._exitedEvents.begin(), recorder._exitedEvents.end() - CAPACITY);
+    }
+    recorder._threads.erase(std::find(recorder._threads.begin(), recorder._threads.end(), this));
+}
+
+void TraceRecorder::ThreadEvents::copyInOrder(std::vector<Event>& out) const {
+    // once the ring has wrapped the oldest event sits where the next one will be written
+    GLuint oldest = numRecorded < CAPACITY ? 0 : nextEvent;
+    for (GLuint i = 0; i < numRecorded; i++) {
+        out.push_back(events[(oldest + i) % CAPACITY]);
+    }
+}
+
+void TraceRecorder::_addEvent(GLuint id, Phase phase, std::chrono::steady_clock::time_point time) {
+    if (!_enabled.load(std::memory_order_relaxed)) return;
+    Event event = {id, _getThreadId(), phase, std::chrono::duration<GLdouble, std::micro>(time - _startTime).count()};
+
+    ThreadEvents& threadEvents = _getThreadEvents();
+    std::lock_guard<std::mutex> lock(threadEvents.mutex);
+    threadEvents.events[threadEvents.nextEvent] = event;
+    threadEvents.nextEvent = (threadEvents.nextEvent + 1) % CAPACITY;
+    if (threadEvents.numRecorded < CAPACITY) threadEvents.numRecorded++;
+}
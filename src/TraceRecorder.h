@@ -0,0 +1,96 @@
+#ifndef A5_TRACE_RECORDER_H
+#define A5_TRACE_RECORDER_H
+
+#include "GLTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// \desc keeps the most recent zone begin and end events and frame boundaries of every thread in
+/// a ring buffer per thread, and writes them out in the Chrome trace event format for
+/// about:tracing or Perfetto.  Nothing is recorded until it is enabled
+class TraceRecorder {
+public:
+    /// \desc number of events kept for each thread, older events are overwritten
+    static constexpr GLuint CAPACITY = 1 << 16;
+
+    /// \desc the recorder shared by every thread
+    static TraceRecorder& instance();
+
+    /// \desc starts or stops recording events, off until a trace is asked for so zones cost no
+    /// more than a flag check
+    void setEnabled( bool enabled ) { _enabled.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /// \desc labels the calling thread in the trace
+    /// \param name name of the thread, must outlive the recorder such as a string literal
+    void setThreadName( const char* name );
+
+    /// \desc a profiler zone started on the calling thread
+    void beginZone( GLuint zoneId, std::chrono::steady_clock::time_point time );
+    /// \desc a profiler zone ended on the calling thread
+    void endZone( GLuint zoneId, std::chrono::steady_clock::time_point time );
+    /// \desc a new frame started on the calling thread
+    void markFrame( GLuint frameNumber );
+
+    /// \desc writes every event still in the buffers as a Chrome trace JSON file, the buffers are
+    /// copied first so recording carries on while the file is written
+    /// \returns false if the file could not be written
+    [[nodiscard]] bool writeJson( const char* filename ) const;
+
+private:
+    TraceRecorder();
+
+    enum class Phase : GLubyte { BEGIN, END, FRAME };
+
+    struct Event {
+        /// \desc profiler zone id, or the frame number for frame events
+        GLuint id;
+        GLuint threadId;
+        Phase phase;
+        /// \desc microseconds since the recorder was created
+        GLdouble timestampUs;
+    };
+
+    /// \desc the most recent events of one thread.  Only the owning thread adds to it, so its lock
+    /// is only ever contended while writeJson copies the events out
+    struct ThreadEvents {
+        ~ThreadEvents();
+
+        /// \desc appends the events in the ring oldest first, mutex must be held
+        void copyInOrder( std::vector<Event>& out ) const;
+
+        std::mutex mutex;
+        /// \desc ring of CAPACITY events, allocated when the thread records its first one
+        std::vector<Event> events;
+        /// \desc position in events the next event is written to
+        GLuint nextEvent = 0;
+        /// \desc number of events in the ring, stops growing once it is full
+        GLuint numRecorded = 0;
+        /// \desc true once the recorder knows of the buffer
+        bool registered = false;
+    };
+
+    /// \desc small sequential id of the calling thread, assigned on first use
+    static GLuint _getThreadId();
+    /// \desc the calling thread's buffer, registered on first use and kept when the thread exits
+    ThreadEvents& _getThreadEvents();
+    void _addEvent( GLuint id, Phase phase, std::chrono::steady_clock::time_point time );
+
+    std::chrono::steady_clock::time_point _startTime;
+    std::atomic<bool> _enabled;
+
+    /// \desc guards everything below, taken when a thread starts or stops recording and while
+    /// writing the file, never for a single event
+    mutable std::mutex _mutex;
+    /// \desc buffer of every thread that has recorded an event and not exited yet
+    std::vector<ThreadEvents*> _threads;
+    /// \desc last CAPACITY events of the threads that have exited, oldest first
+    std::vector<Event> _exitedEvents;
+    std::vector<std::pair<GLuint, const char*>> _threadNames;
+};
+
+#endif //A5_TRACE_RECORDER_H
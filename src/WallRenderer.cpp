@@ -0,0 +1,34 @@
+#include "WallRenderer.h"
+
+#include "MeshBuilder.h"
+#include "MeshUploader.h"
+
+WallRenderer::WallRenderer(GLuint shaderProgramHandle, const Walls& walls, GLint vPosAttributeLocation, GLint vertexNormalAttributeLocation )
+        : _walls(walls) {
+    _shaderProgramHandle = shaderProgramHandle;
+
+    // Bakes every box into one mesh in world space so drawing is a single call.
+    MeshBuilder mesh;
+    _walls.addPartsToMesh(mesh);
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(2, _vbods);
+    // every segment is the same cube, so segment i owns a fixed slice of the index buffer
+    _numIndicesPerBox = MeshUploader::upload(mesh, _vao, _vbods[0], _vbods[1], vPosAttributeLocation, vertexNormalAttributeLocation) / (GLsizei)_walls.getBoxes().size();
+}
+
+WallRenderer::~WallRenderer() {
+    glDeleteBuffers(2, _vbods);
+    glDeleteVertexArrays(1, &_vao);
+}
+
+// Main function to queue the walls as a whole.
+void WallRenderer::submitWalls(glm::mat4 modelMtx, FrustumCuller& culler, RenderQueue& queue ) {
+    const std::vector<AABB>& boxes = _walls.getBoxes();
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (culler.isBoxVisible(boxes[i])) {
+            auto indexOffset = (GLsizeiptr)(i * _numIndicesPerBox * sizeof(GLuint));
+            queue.submit( {_shaderProgramHandle, _vao, GL_TRIANGLES, GL_UNSIGNED_INT, _numIndicesPerBox, indexOffset, 0, modelMtx, _walls.getWallColor()} );
+        }
+    }
+}
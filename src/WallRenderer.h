@@ -0,0 +1,44 @@
+#ifndef A5_WALL_RENDERER_H
+#define A5_WALL_RENDERER_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "FrustumCuller.h"
+#include "RenderQueue.h"
+#include "Walls.h"
+
+class WallRenderer {
+public:
+    /// \desc bakes every wall segment into one static mesh in world space
+    /// \param shaderProgramHandle shader program handle that the walls should be drawn using
+    /// \param walls walls to bake, must outlive the renderer
+    /// \param vPosAttributeLocation attribute location for the vertex position
+    /// \param vertexNormalAttributeLocation attribute location for the vertex normal
+    WallRenderer(GLuint shaderProgramHandle, const Walls& walls, GLint vPosAttributeLocation, GLint vertexNormalAttributeLocation );
+    ~WallRenderer();
+
+    /// \desc queues the model walls for a given model matrix
+    /// \param modelMtx existing model matrix to apply to walls
+    /// \param culler frustum for this frame, wall segments outside of it are skipped
+    /// \param queue render queue a packet per visible segment is submitted to
+    /// \note the segments share mesh, material and transform, so the queue merges them back
+    /// into a single multi-draw call
+    void submitWalls( glm::mat4 modelMtx, FrustumCuller& culler, RenderQueue& queue );
+
+private:
+    /// \desc handle of the shader program to use when drawing the walls
+    GLuint _shaderProgramHandle;
+    /// \desc walls the mesh was baked from
+    const Walls& _walls;
+
+    /// \desc VAO for the baked walls mesh
+    GLuint _vao;
+    /// \desc 0 - VBO, 1 - IBO
+    GLuint _vbods[2];
+    /// \desc number of indices making up each wall segment in the baked mesh
+    GLsizei _numIndicesPerBox;
+};
+
+#endif //A5_WALL_RENDERER_H
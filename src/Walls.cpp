@@ -3,18 +3,11 @@
 //
 
 #include "Walls.h"
+#include "MeshBuilder.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
-#include <CSCI441/objects.hpp>
-#include <CSCI441/OpenGLUtils.hpp>
-
-Walls::Walls(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation ) {
-    _shaderProgramHandle                            = shaderProgramHandle;
-    _shaderProgramUniformLocations.mvpMtx           = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx        = normalMtxUniformLocation;
-    _shaderProgramUniformLocations.materialColor    = materialColorUniformLocation;
-
+Walls::Walls(GLuint numLayoutWalls) {
     _northWallPosBig = glm::vec3(36,0,0);
     _eastWallPosBig = glm::vec3(0,0,36);
     _southWallPosBig = glm::vec3(-36,0,0);
@@ -31,114 +24,42 @@ Walls::Walls(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint norm
     _scaleSmallWallz = glm::vec3(3.0f, 5.0f, 27.0f);
 
     _colorWalls = glm::vec3(0.4f, 0.4f, 0.4f);
-}
 
-// Main function to put together the walls and draw it as a whole.
-void Walls::drawWalls(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) {
-    _drawBigWall(modelMtx, viewMtx, projMtx);
-    _drawSmallWall(modelMtx, viewMtx, projMtx);
+    // Lays out the big walls followed by the small walls.
+    const glm::vec3 layoutPositions[NUM_LAYOUT_WALLS] = {
+            _northWallPosBig, _southWallPosBig, _eastWallPosBig, _westWallPosBig,
+            _northWallPosSmall, _southWallPosSmall, _eastWallPosSmall, _westWallPosSmall
+    };
+    const glm::vec3 layoutScales[NUM_LAYOUT_WALLS] = {
+            _scaleBigWallz, _scaleBigWallz, _scaleBigWallx, _scaleBigWallx,
+            _scaleSmallWallz, _scaleSmallWallz, _scaleSmallWallx, _scaleSmallWallx
+    };
+    for (GLuint i = 0; i < numLayoutWalls && i < NUM_LAYOUT_WALLS; i++) {
+        addWall(layoutPositions[i], layoutScales[i]);
+    }
 }
 
-const glm::vec3 &Walls::getNorthWallPosition() const {
-    return _northWallPosBig;
+// Adds every box in world space so the whole set of walls can be drawn from one mesh.
+void Walls::addPartsToMesh(MeshBuilder& mesh) const {
+    for (const AABB& box : _boxes) {
+        glm::mat4 modelMtx = glm::translate( glm::mat4(1.0f), box.getCenter() );
+        modelMtx = glm::scale( modelMtx, box.maxCorner - box.minCorner );
+        mesh.addCube( modelMtx );
+    }
 }
 
-const glm::vec3 &Walls::getEastWallPosition() const {
-    return _eastWallPosBig;
+const std::vector<AABB> &Walls::getBoxes() const {
+    return _boxes;
 }
 
-const glm::vec3 &Walls::getSouthWallPosition() const {
-    return _southWallPosBig;
+const glm::vec3 &Walls::getWallColor() const {
+    return _colorWalls;
 }
 
-const glm::vec3 &Walls::getWestWallPosition() const {
-    return _westWallPosBig;
+void Walls::addWall(glm::vec3 position, glm::vec3 scale) {
+    _boxes.emplace_back( AABB::fromCenterSize(position, scale) );
 }
 
-// Function to draw the big walls.
-void Walls::_drawBigWall(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _northWallPosBig );
-    modelMtx1 = glm::scale( modelMtx1, _scaleBigWallz );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx2 = glm::translate( modelMtx, _southWallPosBig );
-    modelMtx2 = glm::scale( modelMtx2, _scaleBigWallz );
-
-    _computeAndSendMatrixUniforms(modelMtx2, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx3 = glm::translate( modelMtx, _eastWallPosBig );
-    modelMtx3 = glm::scale( modelMtx3, _scaleBigWallx );
-
-    _computeAndSendMatrixUniforms(modelMtx3, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx4 = glm::translate( modelMtx, _westWallPosBig );
-    modelMtx4 = glm::scale( modelMtx4, _scaleBigWallx );
-
-    _computeAndSendMatrixUniforms(modelMtx4, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
+void Walls::buildHierarchy() {
+    _hierarchy.build( _boxes );
 }
-
-// Function to draw the small walls.
-void Walls::_drawSmallWall(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 modelMtx1 = glm::translate( modelMtx, _northWallPosSmall );
-    modelMtx1 = glm::scale( modelMtx1, _scaleSmallWallz );
-
-    _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx2 = glm::translate( modelMtx, _southWallPosSmall );
-    modelMtx2 = glm::scale( modelMtx2, _scaleSmallWallz );
-
-    _computeAndSendMatrixUniforms(modelMtx2, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx3 = glm::translate( modelMtx, _eastWallPosSmall );
-    modelMtx3 = glm::scale( modelMtx3, _scaleSmallWallx );
-
-    _computeAndSendMatrixUniforms(modelMtx3, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-
-    glm::mat4 modelMtx4 = glm::translate( modelMtx, _westWallPosSmall );
-    modelMtx4 = glm::scale( modelMtx4, _scaleSmallWallx );
-
-    _computeAndSendMatrixUniforms(modelMtx4, viewMtx, projMtx);
-
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorWalls[0]);
-
-    CSCI441::drawSolidCube( 1.0 );
-}
-
-void Walls::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    // precompute the Model-View-Projection matrix on the CPU
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
-    // then send it to the shader on the GPU to apply to every vertex
-    glProgramUniformMatrix4fv( _shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, &mvpMtx[0][0] );
-
-    glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMtx )));
-    glProgramUniformMatrix3fv( _shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, &normalMtx[0][0] );
-}
\ No newline at end of file
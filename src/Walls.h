@@ -5,46 +5,50 @@
 #ifndef A5_WALLS_H
 #define A5_WALLS_H
 
-#include <GL/glew.h>
+#include "GLTypes.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <vector>
 
+#include "AABB.h"
+#include "StaticBVH.h"
+
+class MeshBuilder;
+
 class Walls {
 public:
-    /// \desc creates a simple walls
-    /// \param shaderProgramHandle shader program handle that the walls should be drawn using
-    /// \param mvpMtxUniformLocation uniform location for the full precomputed MVP matrix
-    /// \param normalMtxUniformLocation uniform location for the precomputed Normal matrix
-    /// \param materialColorUniformLocation uniform location for the material diffuse color
-    Walls(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation );
-
-    /// \desc draws the model walls for a given MVP matrix
-    /// \param modelMtx existing model matrix to apply to walls
-    /// \param viewMtx camera view matrix to apply to walls
-    /// \param projMtx camera projection matrix to apply to walls
-    /// \note internally uses the provided shader program and sets the necessary uniforms
-    /// for the MVP and Normal Matrices as well as the material diffuse color
-    void drawWalls( glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx );
-    [[nodiscard]] const glm::vec3 &getNorthWallPosition() const;
-    [[nodiscard]] const glm::vec3 &getEastWallPosition() const;
-    [[nodiscard]] const glm::vec3 &getSouthWallPosition() const;
-    [[nodiscard]] const glm::vec3 &getWestWallPosition() const;
+    /// \desc number of segments in the standard layout of big and small walls
+    static constexpr GLuint NUM_LAYOUT_WALLS = 8;
 
-private:
-    /// \desc handle of the shader program to use when drawing the walls
-    GLuint _shaderProgramHandle;
-    /// \desc stores the uniform locations needed for the plan information
-    struct ShaderProgramUniformLocations {
-        /// \desc location of the precomputed ModelViewProjection matrix
-        GLint mvpMtx;
-        /// \desc location of the precomputed Normal matrix
-        GLint normalMtx;
-        /// \desc location of the material diffuse color
-        GLint materialColor;
-    } _shaderProgramUniformLocations;
+    /// \desc creates the simple walls
+    /// \param numLayoutWalls how many segments of the standard layout to build, big walls first
+    /// \note walls hold no GL state, they are drawn by the WallRenderer
+    explicit Walls(GLuint numLayoutWalls = NUM_LAYOUT_WALLS);
+
+    /// \desc adds a wall segment to the list of boxes
+    /// \param position center of the wall segment
+    /// \param scale size of the wall segment along each axis
+    /// \note the segment is not collided with until the hierarchy is rebuilt
+    void addWall(glm::vec3 position, glm::vec3 scale);
+
+    /// \desc builds the hierarchy over every wall segment, once the level's walls are all added
+    void buildHierarchy();
+
+    /// \desc appends every wall segment to a mesh in world space, one cube per box in box order
+    /// \param mesh builder to add the wall segments to
+    void addPartsToMesh( MeshBuilder& mesh ) const;
 
+    /// \desc world space boxes making up the walls
+    [[nodiscard]] const std::vector<AABB> &getBoxes() const;
+
+    /// \desc the same boxes in a hierarchy for collision, overlap and ray queries
+    [[nodiscard]] const StaticBVH &getHierarchy() const { return _hierarchy; }
+
+    /// \desc material color of every wall segment
+    [[nodiscard]] const glm::vec3 &getWallColor() const;
+
+private:
     glm::vec3 _northWallPosBig;
     glm::vec3 _eastWallPosBig;
     glm::vec3 _southWallPosBig;
@@ -62,18 +66,10 @@ private:
 
     glm::vec3 _colorWalls;
 
-    std::vector<glm::vec3> _wallsLocation;
-
-    void _drawSmallWall(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawBigWall(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-
-    /// \desc precomputes the matrix uniforms CPU-side and then sends them
-    /// to the GPU to be used in the shader for each vertex.  It is more efficient
-    /// to calculate these once and then use the resultant product in the shader.
-    /// \param modelMtx model transformation matrix
-    /// \param viewMtx camera view matrix
-    /// \param projMtx camera projection matrix
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
+    /// \desc every wall segment as a world space box
+    std::vector<AABB> _boxes;
+    /// \desc every wall segment, reported by its index in _boxes
+    StaticBVH _hierarchy;
 };
 
 #endif //A5_WALLS_H
@@ -0,0 +1,28 @@
+#include "WorldSnapshot.h"
+
+WorldSnapshot::WorldSnapshot() {
+    finished = false;
+    tickCount = 0;
+    tickTime = 0.0;
+    inputSequence = 0;
+}
+
+void WorldSnapshot::capture(const GameWorld& world, GLdouble time, GLuint lastInputSequence) {
+    hero = world.getHero();
+
+    // copying into vectors that are already big enough reuses their storage, so after the first
+    // capture nothing is allocated
+    enemies = world.getEnemies();
+
+    // the world keeps its changes until the render thread has taken a snapshot holding them,
+    // and clear keeps the capacity too
+    changedTiles.clear();
+    for (GLuint tile : world.getChangedTiles()) {
+        changedTiles.push_back({tile, world.getTiles()[tile].color});
+    }
+
+    finished = world.isFinished();
+    tickCount = world.getTickCount();
+    tickTime = time;
+    inputSequence = lastInputSequence;
+}
@@ -0,0 +1,48 @@
+#ifndef A5_WORLD_SNAPSHOT_H
+#define A5_WORLD_SNAPSHOT_H
+
+#include "GLTypes.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "EnemyHorde.h"
+#include "GameWorld.h"
+#include "Hero.h"
+
+/// \desc everything the renderer needs from one simulation tick, copied out of the world so
+/// it can be drawn while the simulation thread keeps stepping
+struct WorldSnapshot {
+    /// \desc a tile whose color changed
+    struct TileChange {
+        /// \desc index into GameWorld::getTiles
+        GLuint tile;
+        glm::vec3 color;
+    };
+
+    /// \desc copy of the hero, including the state of the previous tick to blend from
+    Hero hero;
+    /// \desc copy of every enemy, including the state of the previous tick to blend from
+    EnemyHorde enemies;
+    /// \desc every tile change since the last snapshot the render thread took, in the order they
+    /// happened, so snapshots the render thread skips lose nothing
+    std::vector<TileChange> changedTiles;
+    /// \desc the game has ended and the window should close
+    bool finished;
+    /// \desc number of ticks stepped when the snapshot was taken
+    GLuint tickCount;
+    /// \desc simulation clock time in seconds at which the tick was due
+    GLdouble tickTime;
+    /// \desc sequence number of the controls the last tick was stepped with, see SimulationThread::setInput
+    GLuint inputSequence;
+
+    WorldSnapshot();
+
+    /// \desc copies the current state of the world, reusing the storage of the last capture
+    /// \param world world to copy from
+    /// \param time simulation clock time in seconds at which the last tick was due
+    /// \param lastInputSequence sequence number of the controls the last tick was stepped with
+    void capture( const GameWorld& world, GLdouble time, GLuint lastInputSequence );
+};
+
+#endif //A5_WORLD_SNAPSHOT_H
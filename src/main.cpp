@@ -12,16 +12,101 @@
  */
 
 #include "A5Engine.h"
+#include "TraceRecorder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+/// \desc seed a stress run builds its scene from unless one is given
+static constexpr GLuint STRESS_SEED = 441;
+
+/// \desc lists every option, printed when the command line holds one that is not understood
+static void printUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--record FILE] [--stress FRAMES] [--enemies N] [--tiles CxR] [--walls N] [--seed N]\n", program);
+    fprintf(stderr, "       %*s [--vsync off|on|adaptive] [--fps N] [--low-latency] [--trace]\n", (int)strlen(program), "");
+}
+
 ///*****************************************************************************
 //
 // Our main function
-int main() {
+int main(int argc, char* argv[]) {
 
-    auto labEngine = new A5Engine();
+    // --record FILE saves every tick's controls so the session can be replayed by A5Sim
+    // --stress FRAMES draws a fixed number of frames and reports how long they took, the scene
+    // is shaped by --enemies N --tiles CxR --walls N --seed N
+    // --vsync off|on|adaptive and --fps N control how frames are paced
+    // --low-latency polls input at the start of each frame rather than after the swap
+    // --trace keeps the timeline of every profiled zone, written to trace.json on T and on exit
+    GameWorld::Config worldConfig;
+    const char* recordingFilename = nullptr;
+    GLuint stressFrames = 0;
+    FramePacer::VsyncMode vsyncMode = FramePacer::VsyncMode::ON;
+    GLdouble targetFps = 0.0;
+    bool lowLatencyLoop = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--low-latency") == 0) {
+            lowLatencyLoop = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--trace") == 0) {
+            TraceRecorder::instance().setEnabled(true);
+            continue;
+        }
+        // every other option takes a value
+        const bool hasValue = i + 1 < argc;
+        if (hasValue && strcmp(argv[i], "--record") == 0) {
+            recordingFilename = argv[++i];
+        } else if (hasValue && strcmp(argv[i], "--stress") == 0) {
+            stressFrames = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if (hasValue && strcmp(argv[i], "--enemies") == 0) {
+            worldConfig.numEnemies = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if (hasValue && strcmp(argv[i], "--tiles") == 0) {
+            if (sscanf(argv[++i], "%ux%u", &worldConfig.tileColumns, &worldConfig.tileRows) != 2
+                || worldConfig.tileColumns == 0 || worldConfig.tileRows == 0) {
+                fprintf(stderr, "[ERROR]: --tiles expects COLUMNSxROWS, such as 12x12\n");
+                return EXIT_FAILURE;
+            }
+        } else if (hasValue && strcmp(argv[i], "--walls") == 0) {
+            worldConfig.numWalls = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if (hasValue && strcmp(argv[i], "--seed") == 0) {
+            worldConfig.seed = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if (hasValue && strcmp(argv[i], "--vsync") == 0) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "off") == 0) {
+                vsyncMode = FramePacer::VsyncMode::OFF;
+            } else if (strcmp(mode, "on") == 0) {
+                vsyncMode = FramePacer::VsyncMode::ON;
+            } else if (strcmp(mode, "adaptive") == 0) {
+                vsyncMode = FramePacer::VsyncMode::ADAPTIVE;
+            } else {
+                fprintf(stderr, "[ERROR]: --vsync expects off, on or adaptive\n");
+                return EXIT_FAILURE;
+            }
+        } else if (hasValue && strcmp(argv[i], "--fps") == 0) {
+            targetFps = strtod(argv[++i], nullptr);
+        } else {
+            fprintf(stderr, "[ERROR]: %s is not an option or is missing its value\n", argv[i]);
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    // stress runs compare builds against each other, so they always build the same scene
+    if (stressFrames > 0 && worldConfig.seed == 0) {
+        worldConfig.seed = STRESS_SEED;
+    }
+
+    auto labEngine = new A5Engine(worldConfig);
+    if (recordingFilename != nullptr) {
+        labEngine->setRecordingFile(recordingFilename);
+    }
+    labEngine->setStressFrames(stressFrames);
+    labEngine->setVsyncMode(vsyncMode);
+    labEngine->setTargetFps(targetFps);
+    labEngine->setLowLatencyLoop(lowLatencyLoop);
     labEngine->initialize();
     if (labEngine->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR) {
         labEngine->run();
@@ -1,38 +1,40 @@
 #version 410 core
 
-// uniform inputs
-uniform mat4 mvpMatrix;                 // the precomputed Model-View-Projection Matrix
-// TODO #D: add normal matrix
-uniform mat3 normalMatrix;
-
-// TODO #A: add light uniforms
-uniform vec3 lightDirection;
-uniform vec3 lightColor;
-
+// per-frame uniform inputs shared by every shader, uploaded once per frame
+layout(std140) uniform FrameData {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjMatrix;                // the precomputed View-Projection Matrix
+    vec4 lightDirection;                // xyz is the direction the light travels
+    vec4 lightColor;                    // rgb is the color of the light
+};
+
+// per-object uniform inputs
+uniform mat4 modelMatrix;               // the Model Matrix for the object being drawn
 uniform vec3 materialColor;             // the material color for our vertex (& whole object)
 
 // attribute inputs
 layout(location = 0) in vec3 vPos;      // the position of this specific vertex in object space
-// TODO #C: add vertex normal
 layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec3 vertexColor;  // baked per-part color, white for meshes without one
 
 // varying outputs
 layout(location = 0) out vec3 color;    // color to apply to this vertex
 
 void main() {
     // transform & output the vertex in clip space
-    gl_Position = mvpMatrix * vec4(vPos, 1.0);
+    gl_Position = viewProjMatrix * modelMatrix * vec4(vPos, 1.0);
 
-    // TODO #B: compute Light vector
-    vec3 lightVec = normalize(-lightDirection);
+    vec3 lightVec = normalize(-lightDirection.xyz);
 
-    // TODO #E: transform normal vector
+    // the cofactor matrix is the inverse transpose scaled by the determinant, which
+    // the normalize below cancels out, so the normal matrix needs no inverse
+    mat3 m = mat3(modelMatrix);
+    mat3 normalMatrix = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
     vec3 worldSpaceNormal = normalize(normalMatrix * vertexNormal);
 
-    // TODO #F: perform diffuse calculation
     float diffuseFactor = max(dot(worldSpaceNormal, lightVec), 0.0);
-    vec3 diffuseColor = lightColor * materialColor * diffuseFactor;
+    vec3 diffuseColor = lightColor.rgb * materialColor * vertexColor * diffuseFactor;
 
-    // TODO #G: assign the color for this vertex
     color = diffuseColor;
-}
\ No newline at end of file
+}
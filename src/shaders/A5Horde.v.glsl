@@ -0,0 +1,45 @@
+#version 410 core
+
+// per-frame uniform inputs shared by every shader, uploaded once per frame
+layout(std140) uniform FrameData {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjMatrix;                // the precomputed View-Projection Matrix
+    vec4 lightDirection;                // xyz is the direction the light travels
+    vec4 lightColor;                    // rgb is the color of the light
+};
+
+// attribute inputs
+layout(location = 0) in vec3 vPos;      // the position of this specific vertex in object space
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec3 vertexColor;
+
+// per-instance attribute inputs
+layout(location = 3) in vec4 instancePositionHeading;    // xyz is the world position, w the heading about +y
+layout(location = 4) in vec3 instanceScale;              // scale of the whole body
+layout(location = 5) in vec3 instanceColor;              // tints the parts that were baked white
+
+// varying outputs
+layout(location = 0) out vec3 color;    // color to apply to this vertex
+
+void main() {
+    // rebuild translate * rotate(heading, +y) * scale from the compact instance data
+    float c = cos(instancePositionHeading.w);
+    float s = sin(instancePositionHeading.w);
+    mat3 rotation = mat3( c, 0.0, -s,
+                        0.0, 1.0, 0.0,
+                          s, 0.0,  c );
+
+    vec3 worldPos = instancePositionHeading.xyz + rotation * (instanceScale * vPos);
+    gl_Position = viewProjMatrix * vec4(worldPos, 1.0);
+
+    vec3 lightVec = normalize(-lightDirection.xyz);
+
+    // inverse transpose of rotate * scale is rotate * inverse(scale)
+    vec3 worldSpaceNormal = normalize(rotation * (vertexNormal / instanceScale));
+
+    float diffuseFactor = max(dot(worldSpaceNormal, lightVec), 0.0);
+    vec3 diffuseColor = lightColor.rgb * instanceColor * vertexColor * diffuseFactor;
+
+    color = diffuseColor;
+}
@@ -0,0 +1,36 @@
+#version 410 core
+
+// per-frame uniform inputs shared by every shader, uploaded once per frame
+layout(std140) uniform FrameData {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjMatrix;                // the precomputed View-Projection Matrix
+    vec4 lightDirection;                // xyz is the direction the light travels
+    vec4 lightColor;                    // rgb is the color of the light
+};
+
+// attribute inputs
+layout(location = 0) in vec3 vPos;      // the position of this specific vertex in object space
+layout(location = 1) in vec3 vertexNormal;
+
+// per-instance attribute inputs
+layout(location = 2) in mat4 instanceModelMatrix;     // occupies locations 2-5
+layout(location = 6) in mat3 instanceNormalMatrix;    // occupies locations 6-8
+layout(location = 9) in vec3 instanceColor;           // the material color for this instance
+
+// varying outputs
+layout(location = 0) out vec3 color;    // color to apply to this vertex
+
+void main() {
+    // transform & output the vertex in clip space
+    gl_Position = viewProjMatrix * instanceModelMatrix * vec4(vPos, 1.0);
+
+    vec3 lightVec = normalize(-lightDirection.xyz);
+
+    vec3 worldSpaceNormal = normalize(instanceNormalMatrix * vertexNormal);
+
+    float diffuseFactor = max(dot(worldSpaceNormal, lightVec), 0.0);
+    vec3 diffuseColor = lightColor.rgb * instanceColor * diffuseFactor;
+
+    color = diffuseColor;
+}